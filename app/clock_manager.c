@@ -20,24 +20,45 @@
 
 #include "clock_manager.h"
 
+#include <stddef.h>
+
 #include <event.h>
 
+#include <civil_time.h>
+#include <alarm_queue.h>
+
 #include <hal.h>
 
 //------------------------------------------------------------------------------
 
-#define CLOCK_MANAGER_TIMESTAMP(h, m) (struct hal_timestamp){.hours = h, .minutes = m}
-
-#define CLOCK_MANAGER_SYNC_TIMESTAMP CLOCK_MANAGER_TIMESTAMP(4, 0)  /* Auto synchronization at 04:00 */
+#define CLOCK_MANAGER_SYNC_HOURS 4                                  /* Auto synchronization at 04:00 */
+#define CLOCK_MANAGER_SYNC_MINUTES 0
+#define CLOCK_MANAGER_SYNC_ALARM_ID HAL_ALARMS_COUNT                /* Auto synchronization is scheduled with user alarms */
 #define CLOCK_MANAGER_DCF77_TIME_ZONE 1                             /* DCF77 sends time signal in UTC+1 time zone (UTC+2 for DST) */
+#define CLOCK_MANAGER_DST_CHANGE_HOUR_UTC 1                         /* EU rule - last Sunday of March and October at 01:00 UTC */
+#define CLOCK_MANAGER_ALARM_CATCH_UP_S 600UL                        /* Alarms passed by smaller DCF77 correction are fired */
+#define CLOCK_MANAGER_DST_CHANGE_WINDOW_S 10UL                      /* DST change passed by larger time jump is not a crossing */
+
+/* Warm state flags (kept over watchdog / brown-out reset) */
+#define CLOCK_MANAGER_WARM_FLAG_TIME_VALID (1 << 0)                 /* RTC was set by synchronization or user since cold boot */
+
+/* RTC time is processed in place by civil time library */
+_Static_assert(ALARM_QUEUE_SIZE > CLOCK_MANAGER_SYNC_ALARM_ID, "Alarm queue too small");
+
+_Static_assert(sizeof(struct civil_time) == sizeof(struct ds1307_time) &&
+               offsetof(struct civil_time, day) == offsetof(struct ds1307_time, day) &&
+               offsetof(struct civil_time, year) == offsetof(struct ds1307_time, year), "Time layout mismatch");
 
 //------------------------------------------------------------------------------
 
 struct clock_manager_ctx
 {
     volatile bool new_sec;
-    struct hal_timestamp alarm;
-    int8_t timezone;
+    struct alarm_queue alarms;  /* User alarms and auto synchronization in local time */
+    int8_t timezone;        /* Standard time offset from UTC [h] */
+    bool dst;               /* Daylight saving time (+1 h) */
+    uint32_t utc;           /* RTC time [s since 2000-01-01 UTC] */
+    uint32_t dst_change;    /* Next DST change [s since 2000-01-01 UTC] */
 };
 
 static struct clock_manager_ctx ctx;
@@ -53,124 +74,132 @@ void hal_exti_sqw_cb(void) // Called from ISR
 
 //------------------------------------------------------------------------------
 
-static bool timestamp_is_reached(event_update_time_req_data_t *time, struct hal_timestamp *timestamp)
+static struct civil_time *to_civil_time(struct ds1307_time *time)
 {
-#if 1
-    return (time->seconds == 0 &&  time->minutes == timestamp->minutes && time->hours == timestamp->hours);
-#else 
-    /* Safe version of timestamp check - robust against interrupt loss / rtc communication failure */ 
-    /* Due to value editing, timestamp struct cannot be temporary object created in-place */ 
-    if ((time->minutes + 60 * time->hours) >= (timestamp->minutes + 60 * timestamp->hours))
+    return (struct civil_time *)time;
+}
+
+static uint32_t eu_dst_change(uint8_t year, uint8_t month)
+{
+    struct civil_time last_day = {.date = 31, .month = month, .year = year};
+
+    uint16_t days = civil_time_to_days(&last_day);
+
+    /* Last Sunday (weekday 7) */
+    days -= civil_time_weekday(days) % 7;
+
+    return days * CIVIL_TIME_SECONDS_PER_DAY + CLOCK_MANAGER_DST_CHANGE_HOUR_UTC * 3600UL;
+}
+
+/* DST state by EU rule - used when DCF77 did not tell otherwise, so change happens on time without receiver session */
+static bool dst_rule(uint32_t utc, uint32_t *next_change)
+{
+    struct civil_time time;
+
+    civil_time_from_epoch(utc, &time);
+
+    uint32_t start = eu_dst_change(time.year, 3);
+    uint32_t end = eu_dst_change(time.year, 10);
+
+    if (utc < start)
     {
-        if (!timestamp->is_handled)
-        {
-            timestamp->is_handled = true;
-            return true;
-        }
+        *next_change = start;
+        return false;
     }
-    else
-        timestamp->is_handled = false;
 
+    if (utc < end)
+    {
+        *next_change = end;
+        return true;
+    }
+
+    *next_change = eu_dst_change(time.year + 1, 3);
     return false;
-#endif
 }
 
-static const uint8_t days[] = {31,28,31,30,31,30,31,31,30,31,30,31};
-
-static bool is_leap_year(uint8_t year)
+static int32_t utc_offset(void)
 {
-    year += 2000;
-    return ((year % 4 == 0) && ((year % 100 != 0) || (year % 400 == 0)));
+    return (ctx.timezone + ctx.dst) * 3600L;
 }
 
-static uint8_t days_in_month(uint8_t m, uint8_t y)
+static void set_utc(uint32_t utc)
 {
-    if (m == 2 && is_leap_year(y)) 
-        return 29;
+    struct ds1307_time time;
 
-    if (m >= 1 && m <= 12) 
-        return days[m-1];
-    
-    return 31;
+    civil_time_from_epoch(utc, to_civil_time(&time));
+
+    if (hal_set_time(&time))
+        hal_set_warm_flags(hal_get_warm_flags() | CLOCK_MANAGER_WARM_FLAG_TIME_VALID);
+
+    ctx.utc = utc;
 }
 
-static void shift_time(event_set_time_req_data_t *t, int8_t tz)
+/* Local time is kept in update time request data - displayed and sent, alarms are compared with returned epoch */
+static uint32_t update_local_time(void)
 {
-    int8_t h = t->hours + tz;
-    int8_t d = t->date; 
-    int8_t m = t->month; 
-    int8_t y = t->year;
+    uint32_t local = civil_time_epoch_add(ctx.utc, utc_offset());
 
-    if (h < 0)
-    {
-        h += 24;
-        d--;
-    }
-    else if (h >= 24)
-    {
-        h -= 24;
-        d++;
-    }
+    civil_time_from_epoch(local, to_civil_time(event_get_data(EVENT_UPDATE_TIME_REQ)));
 
-    t->hours = h;
+    return local;
+}
 
-    uint8_t dim = days_in_month(m, y);
+static void set_alarm(uint8_t id, const struct hal_alarm *alarm, uint32_t local)
+{
+    alarm_queue_set(&ctx.alarms, id, alarm->hours, alarm->minutes, alarm->is_enabled ? alarm->weekdays : 0, local);
+}
 
-    if (d < 1)
-    {
-        if (--m < 1)
-        {
-            m = 12; 
-            // y = (y ? y - 1 : 99); 
-        }
+static void schedule_alarms(uint32_t local)
+{
+    struct hal_alarm alarm = {.hours = CLOCK_MANAGER_SYNC_HOURS, .minutes = CLOCK_MANAGER_SYNC_MINUTES, .is_enabled = true, .weekdays = HAL_ALARM_EVERY_DAY};
 
-        d = days_in_month(m, y);
-    }
-    else if (d > dim)
-    {
-        d = 1;
-        
-        if (++m > 12)
-        {
-            m = 1; 
-            // y = (y < 99 ? y + 1 : 0);
-        }
-    }
+    alarm_queue_init(&ctx.alarms);
+
+    set_alarm(CLOCK_MANAGER_SYNC_ALARM_ID, &alarm, local);
 
-    t->date = d;
-    t->month = m;
-    // t->year = y;
+    for (uint8_t id = 0; hal_get_alarm(id, &alarm); id++)
+        set_alarm(id, &alarm, local);
 }
 
 //------------------------------------------------------------------------------
 
 bool clock_manager_init(void)
 {
-    /* Sync time every startup */
-    event_set(EVENT_SYNC_TIME_REQ);
+    /* Sync time every cold startup, after warm reset RTC time is still valid - receiver is not powered for minutes */
+    if (!hal_is_warm_boot() || !(hal_get_warm_flags() & CLOCK_MANAGER_WARM_FLAG_TIME_VALID))
+        event_set(EVENT_SYNC_TIME_REQ);
 
-    hal_get_alarm(&ctx.alarm);
     hal_get_timezone(&ctx.timezone);
 
+    /* RTC keeps UTC */
+    struct ds1307_time time;
+
+    if (hal_get_time(&time))
+        ctx.utc = civil_time_to_epoch(to_civil_time(&time));
+
+    ctx.dst = dst_rule(ctx.utc, &ctx.dst_change);
+
+    /* First screen shows current time instead of waiting for next second tick */
+    schedule_alarms(update_local_time());
+
     return true;
 }
 
 void clock_manager_process(void)
 {
-    if (event_get() & EVENT_SET_TIME_REQ)
-    {
-        event_set_time_req_data_t *time = event_get_data(EVENT_SET_TIME_REQ);
+    enum event_type events = event_get();
 
-        /* Set time request without set time zone request means DCF77 sync request - shift from UTC+01 needed */
-        if (!(event_get() & EVENT_SET_TIMEZONE_REQ))
-            shift_time(time, ctx.timezone - CLOCK_MANAGER_DCF77_TIME_ZONE); 
+    /* Time set by user or timezone change moves local time arbitrarily - passed alarms are not fired */
+    bool reschedule = events & EVENT_SET_TIMEZONE_REQ;
 
-        hal_set_time(event_get_data(EVENT_SET_TIME_REQ));
+    if (events & EVENT_SET_DST_REQ)
+    {
+        event_set_dst_req_data_t *dst = event_get_data(EVENT_SET_DST_REQ);
 
-        event_clear(EVENT_SET_TIME_REQ);
+        ctx.dst = dst->dst;
     }
 
-    if (event_get() & EVENT_SET_TIMEZONE_REQ)
+    if (events & EVENT_SET_TIMEZONE_REQ)
     {
         hal_set_timezone(event_get_data(EVENT_SET_TIMEZONE_REQ));
         hal_get_timezone(&ctx.timezone);
@@ -178,27 +207,95 @@ void clock_manager_process(void)
         event_clear(EVENT_SET_TIMEZONE_REQ);
     }
 
-    if (event_get() & EVENT_SET_ALARM_REQ)
+    if (events & EVENT_SET_TIME_REQ)
+    {
+        uint32_t local = civil_time_to_epoch(to_civil_time(event_get_data(EVENT_SET_TIME_REQ)));
+        uint32_t prev_utc = ctx.utc;
+
+        /* Set time request with set time zone request is local time set by user, otherwise it is DCF77 time (CET / CEST) */
+        if (events & EVENT_SET_TIMEZONE_REQ)
+        {
+            ctx.dst = dst_rule(civil_time_epoch_add(local, -ctx.timezone * 3600L), &ctx.dst_change);
+            set_utc(civil_time_epoch_add(local, -utc_offset()));
+        }
+        else
+        {
+            set_utc(civil_time_epoch_add(local, -(CLOCK_MANAGER_DCF77_TIME_ZONE + ctx.dst) * 3600L));
+            dst_rule(ctx.utc, &ctx.dst_change);
+        }
+
+        /* Large DCF77 correction (RTC lost time) is treated as time set by user */
+        if ((ctx.utc > prev_utc ? ctx.utc - prev_utc : prev_utc - ctx.utc) > CLOCK_MANAGER_ALARM_CATCH_UP_S)
+            reschedule = true;
+
+        event_clear(EVENT_SET_TIME_REQ);
+    }
+
+    if (events & EVENT_SET_DST_REQ)
+    {
+        event_set_dst_req_data_t *dst = event_get_data(EVENT_SET_DST_REQ);
+
+        /* Announcement bit is sent during the hour before change */
+        if (dst->change_announced)
+            ctx.dst_change = (ctx.utc / 3600 + 1) * 3600;
+
+        event_clear(EVENT_SET_DST_REQ);
+    }
+
+    if (events & (EVENT_SET_TIME_REQ | EVENT_SET_TIMEZONE_REQ))
     {
-        hal_set_alarm(event_get_data(EVENT_SET_ALARM_REQ));
-        hal_get_alarm(&ctx.alarm);
+        uint32_t local = update_local_time();
+
+        if (reschedule)
+            alarm_queue_reschedule(&ctx.alarms, local);
+
+        event_set(EVENT_UPDATE_TIME_REQ);
+    }
+
+    if (events & EVENT_SET_ALARM_REQ)
+    {
+        event_set_alarm_req_data_t *req = event_get_data(EVENT_SET_ALARM_REQ);
+
+        if (hal_set_alarm(req->id, &req->alarm))
+            set_alarm(req->id, &req->alarm, civil_time_epoch_add(ctx.utc, utc_offset()));
 
         event_clear(EVENT_SET_ALARM_REQ);
     }
 
     if (ctx.new_sec)
     {
-        event_update_time_req_data_t *time = event_get_data(EVENT_UPDATE_TIME_REQ);
+        struct ds1307_time time;
+
+        /* RTC oscillator still drives SQW when only its bus fails - time is counted from SQW ticks then */
+        if (hal_get_time(&time))
+            ctx.utc = civil_time_to_epoch(to_civil_time(&time));
+        else
+            ctx.utc = civil_time_epoch_add(ctx.utc, 1);
+
+        if (ctx.utc >= ctx.dst_change)
+        {
+            /* Change crossed by second ticks (also the one announced by DCF77) flips DST, time jump past it (e.g. first
+               RTC read after failed one) takes DST state from the rule */
+            if (ctx.utc - ctx.dst_change < CLOCK_MANAGER_DST_CHANGE_WINDOW_S)
+            {
+                ctx.dst = !ctx.dst;
+                dst_rule(ctx.utc, &ctx.dst_change);
+            }
+            else
+            {
+                ctx.dst = dst_rule(ctx.utc, &ctx.dst_change);
+            }
+        }
 
-        hal_get_time(time);
+        uint32_t local = update_local_time();
 
         event_set(EVENT_UPDATE_TIME_REQ | EVENT_SEND_TIME_INFO_REQ);
 
-        if (timestamp_is_reached(time, &CLOCK_MANAGER_SYNC_TIMESTAMP))
-            event_set(EVENT_SYNC_TIME_REQ);
+        /* Single compare with the earliest alarm unless one is due - skipped seconds do not lose alarm */
+        uint8_t id;
 
-        if (ctx.alarm.is_enabled && timestamp_is_reached(time, &ctx.alarm))
-            event_set(EVENT_ALARM_REQ);
+        while (alarm_queue_poll(&ctx.alarms, local, &id))
+            event_set(id == CLOCK_MANAGER_SYNC_ALARM_ID ? EVENT_SYNC_TIME_REQ : EVENT_ALARM_REQ);
 
         ctx.new_sec = false;
     }
@@ -20,14 +20,410 @@
 
 #include "communication_manager.h"
 
+#include <stddef.h>
+#include <string.h>
+
 #include <event.h>
 
+#include <serial_protocol.h>
+#include <civil_time.h>
+#include <scheduler.h>
+
+#include <radio_manager.h>
+
 #include <hal.h>
 
 //------------------------------------------------------------------------------
 
+/* Partial frame is dropped after RX gap longer than that (1 byte takes ~1 ms at 9600 baud) */
+#define COMMUNICATION_MANAGER_RX_TIMEOUT_MS         20
+
+/* Baud rate switched on host request is reverted if no valid frame is received with new baud rate in that time */
+#define COMMUNICATION_MANAGER_BAUDRATE_CONFIRM_MS   2000
+
+#define COMMUNICATION_MANAGER_TIMEZONE_MIN          (-12)
+#define COMMUNICATION_MANAGER_TIMEZONE_MAX          (14)
+
+/* serial_protocol_encode rejects longer payloads - response would be silently dropped */
+_Static_assert(1 + sizeof(struct profiler_stats) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "Profiling stats response too long");
+_Static_assert(1 + sizeof(struct scheduler_task_stats) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "Task stats response too long");
+_Static_assert(sizeof(struct fault_journal_entry) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "Fault journal response too long");
+_Static_assert(sizeof(struct radio_manager_stats) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "Decoder stats response too long");
+_Static_assert(sizeof(struct radio_manager_error_stats) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "Decoder errors response too long");
+_Static_assert(sizeof(((struct dcf77_decoder_quality *)0)->histogram[0]) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "Histogram response too long");
+_Static_assert(sizeof(struct dcf77_decoder_quality) - offsetof(struct dcf77_decoder_quality, out_of_range) <= SERIAL_PROTOCOL_MAX_PAYLOAD,
+               "Quality counters response too long");
+_Static_assert(sizeof(struct stack_monitor_ram_usage) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "RAM usage response too long");
+_Static_assert(sizeof(event_update_time_req_data_t) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "Time response too long");
+_Static_assert(sizeof(event_set_alarm_req_data_t) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "Alarm response too long");
+_Static_assert(sizeof(event_send_time_req_data_t) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "Time info frame too long");
+_Static_assert(sizeof(event_send_diag_req_data_t) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "Diagnostic frame too long");
+_Static_assert(sizeof(struct serial_protocol_nack) <= SERIAL_PROTOCOL_MAX_PAYLOAD, "NACK frame too long");
+
+//------------------------------------------------------------------------------
+
+struct communication_manager_ctx
+{
+    struct serial_protocol_parser parser;   /* Fed from RX ISR, frame is locked until processed */
+    volatile bool frame_ready;
+    uint16_t last_rx_time;
+    bool diag_stream;
+    uint32_t pending_baudrate;  /* Switched after response is sent */
+    bool baudrate_unconfirmed;
+    uint16_t baudrate_switch_time;
+    uint8_t tx_buf[SERIAL_PROTOCOL_MAX_FRAME_SIZE];
+};
+
+static struct communication_manager_ctx ctx;
+
+//------------------------------------------------------------------------------
+
+static void send_frame(uint8_t type, const void *payload, uint8_t len)
+{
+    uint8_t size = serial_protocol_encode(type, payload, len, ctx.tx_buf);
+
+    hal_serial_send(ctx.tx_buf, size);
+}
+
+static void send_response(uint8_t cmd, const void *payload, uint8_t len)
+{
+    send_frame(cmd | SERIAL_PROTOCOL_TYPE_RESPONSE, payload, len);
+}
+
+static void send_nack(uint8_t cmd, enum serial_protocol_nack_reason reason)
+{
+    struct serial_protocol_nack nack = {.type = cmd, .reason = reason};
+
+    send_frame(SERIAL_PROTOCOL_TYPE_NACK, &nack, sizeof(nack));
+}
+
+static bool time_is_valid(const struct ds1307_time *time)
+{
+    return civil_time_is_valid((const struct civil_time *)time);
+}
+
+static bool alarm_is_valid(const event_set_alarm_req_data_t *req)
+{
+    return req->id < HAL_ALARMS_COUNT && req->alarm.hours < 24 && req->alarm.minutes < 60 && req->alarm.is_enabled <= 1 &&
+           req->alarm.weekdays <= HAL_ALARM_EVERY_DAY;
+}
+
+static void send_profiling_stats(uint8_t cmd)
+{
+    struct profiler_stats stats;
+
+    /* One response per measured section, terminated by empty response */
+    for (uint8_t id = 0; hal_get_profiling_stats(id, &stats); id++)
+    {
+        if (stats.count == 0)
+            continue;
+
+        uint8_t payload[1 + sizeof(stats)];
+
+        payload[0] = id;
+        memcpy(&payload[1], &stats, sizeof(stats));
+
+        send_response(cmd, payload, sizeof(payload));
+    }
+
+    send_response(cmd, NULL, 0);
+}
+
+static void send_task_stats(uint8_t cmd)
+{
+    const struct scheduler_task_stats *stats;
+
+    /* One response per task in scheduler task table order, terminated by empty response */
+    for (uint8_t id = 0; (stats = scheduler_get_stats(id)); id++)
+    {
+        uint8_t payload[1 + sizeof(*stats)];
+
+        payload[0] = id;
+        memcpy(&payload[1], stats, sizeof(*stats));
+
+        send_response(cmd, payload, sizeof(payload));
+    }
+
+    send_response(cmd, NULL, 0);
+}
+
+static void send_fault_journal(uint8_t cmd)
+{
+    struct fault_journal_entry entry;
+
+    /* One response per entry from the newest, terminated by empty response */
+    for (uint8_t index = 0; hal_get_fault_journal_entry(index, &entry); index++)
+        send_response(cmd, &entry, sizeof(entry));
+
+    send_response(cmd, NULL, 0);
+}
+
+static void process_frame(const struct serial_protocol_frame *frame)
+{
+    uint8_t cmd = frame->type;
+
+    /* Expected payload length of commands with arguments */
+    uint8_t expected_len = 0;
+
+    if (cmd == SERIAL_PROTOCOL_TYPE_SET_TIME)
+        expected_len = sizeof(event_set_time_req_data_t);
+    else if (cmd == SERIAL_PROTOCOL_TYPE_SET_ALARM)
+        expected_len = sizeof(event_set_alarm_req_data_t);
+    else if (cmd == SERIAL_PROTOCOL_TYPE_GET_ALARM || cmd == SERIAL_PROTOCOL_TYPE_GET_SIGNAL_QUALITY)
+        expected_len = sizeof(uint8_t);
+    else if (cmd == SERIAL_PROTOCOL_TYPE_SET_TIMEZONE)
+        expected_len = sizeof(event_set_timezone_req_data_t);
+    else if (cmd == SERIAL_PROTOCOL_TYPE_SET_DIAG_STREAM || cmd == SERIAL_PROTOCOL_TYPE_SET_CAPTURE)
+        expected_len = sizeof(uint8_t);
+    else if (cmd == SERIAL_PROTOCOL_TYPE_SET_BAUDRATE)
+        expected_len = sizeof(uint32_t);
+
+    if (frame->len != expected_len)
+    {
+        send_nack(cmd, SERIAL_PROTOCOL_NACK_INVALID_LENGTH);
+        return;
+    }
+
+    switch (cmd)
+    {
+    case SERIAL_PROTOCOL_TYPE_GET_TIME:
+
+        send_response(cmd, event_get_data(EVENT_UPDATE_TIME_REQ), sizeof(event_update_time_req_data_t));
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_SET_TIME:
+
+        if (!time_is_valid((const struct ds1307_time *)frame->payload))
+        {
+            send_nack(cmd, SERIAL_PROTOCOL_NACK_INVALID_VALUE);
+            break;
+        }
+
+        memcpy(event_get_data(EVENT_SET_TIME_REQ), frame->payload, sizeof(event_set_time_req_data_t));
+
+        /* Local time - timezone request prevents Clock Manager from shifting it as DCF77 time */
+        hal_get_timezone(event_get_data(EVENT_SET_TIMEZONE_REQ));
+        event_set(EVENT_SET_TIME_REQ | EVENT_SET_TIMEZONE_REQ);
+
+        send_response(cmd, NULL, 0);
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_GET_ALARM:
+    {
+        event_set_alarm_req_data_t alarm = {.id = frame->payload[0]};
+
+        if (!hal_get_alarm(alarm.id, &alarm.alarm))
+        {
+            send_nack(cmd, SERIAL_PROTOCOL_NACK_INVALID_VALUE);
+            break;
+        }
+
+        send_response(cmd, &alarm, sizeof(alarm));
+
+        break;
+    }
+
+    case SERIAL_PROTOCOL_TYPE_SET_ALARM:
+
+        if (!alarm_is_valid((const event_set_alarm_req_data_t *)frame->payload))
+        {
+            send_nack(cmd, SERIAL_PROTOCOL_NACK_INVALID_VALUE);
+            break;
+        }
+
+        memcpy(event_get_data(EVENT_SET_ALARM_REQ), frame->payload, sizeof(event_set_alarm_req_data_t));
+        event_set(EVENT_SET_ALARM_REQ);
+
+        send_response(cmd, NULL, 0);
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_GET_TIMEZONE:
+    {
+        int8_t tz;
+
+        hal_get_timezone(&tz);
+
+        send_response(cmd, &tz, sizeof(tz));
+
+        break;
+    }
+
+    case SERIAL_PROTOCOL_TYPE_SET_TIMEZONE:
+    {
+        int8_t tz = (int8_t)frame->payload[0];
+
+        if (tz < COMMUNICATION_MANAGER_TIMEZONE_MIN || tz > COMMUNICATION_MANAGER_TIMEZONE_MAX)
+        {
+            send_nack(cmd, SERIAL_PROTOCOL_NACK_INVALID_VALUE);
+            break;
+        }
+
+        *(int8_t *)event_get_data(EVENT_SET_TIMEZONE_REQ) = tz;
+        event_set(EVENT_SET_TIMEZONE_REQ);
+
+        send_response(cmd, NULL, 0);
+
+        break;
+    }
+
+    case SERIAL_PROTOCOL_TYPE_SYNC:
+
+        event_set(EVENT_SYNC_TIME_REQ);
+
+        send_response(cmd, NULL, 0);
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_GET_DECODER_STATS:
+
+        send_response(cmd, radio_manager_get_stats(), sizeof(struct radio_manager_stats));
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_GET_DECODER_ERRORS:
+
+        send_response(cmd, radio_manager_get_error_stats(), sizeof(struct radio_manager_error_stats));
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_GET_SIGNAL_QUALITY:
+    {
+        /* Whole metrics do not fit in single frame - 0 selects counters and score, 1 and above selects histogram */
+        struct dcf77_decoder_quality quality;
+        uint8_t index = frame->payload[0];
+
+        if (index > DCF77_DECODER_HISTOGRAM_MAX)
+        {
+            send_nack(cmd, SERIAL_PROTOCOL_NACK_INVALID_VALUE);
+            break;
+        }
+
+        radio_manager_get_quality(&quality);
+
+        if (index)
+            send_response(cmd, quality.histogram[index - 1], sizeof(quality.histogram[0]));
+        else
+            send_response(cmd, &quality.out_of_range, sizeof(quality) - offsetof(struct dcf77_decoder_quality, out_of_range));
+
+        break;
+    }
+
+    case SERIAL_PROTOCOL_TYPE_SET_DIAG_STREAM:
+
+        ctx.diag_stream = !!frame->payload[0];
+
+        send_response(cmd, NULL, 0);
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_SET_CAPTURE:
+
+        radio_manager_set_capture(frame->payload[0]);
+
+        send_response(cmd, NULL, 0);
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_SET_BAUDRATE:
+    {
+        uint32_t baudrate;
+
+        memcpy(&baudrate, frame->payload, sizeof(baudrate));
+
+        if (!hal_serial_baudrate_is_supported(baudrate))
+        {
+            send_nack(cmd, SERIAL_PROTOCOL_NACK_INVALID_VALUE);
+            break;
+        }
+
+        send_response(cmd, NULL, 0);
+
+        ctx.pending_baudrate = baudrate;
+
+        break;
+    }
+
+    case SERIAL_PROTOCOL_TYPE_GET_PROFILING:
+
+        send_profiling_stats(cmd);
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_RESET_PROFILING:
+
+        hal_reset_profiling_info();
+
+        send_response(cmd, NULL, 0);
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_GET_RAM_USAGE:
+    {
+        struct stack_monitor_ram_usage usage;
+
+        hal_get_ram_usage(&usage);
+
+        send_response(cmd, &usage, sizeof(usage));
+
+        break;
+    }
+
+    case SERIAL_PROTOCOL_TYPE_GET_FAULT_JOURNAL:
+
+        send_fault_journal(cmd);
+
+        break;
+
+    case SERIAL_PROTOCOL_TYPE_GET_TASK_STATS:
+
+        send_task_stats(cmd);
+
+        break;
+
+    default:
+
+        send_nack(cmd, SERIAL_PROTOCOL_NACK_UNKNOWN_TYPE);
+
+        break;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/* HAL callbacks */
+
+void hal_serial_rx_cb(uint8_t byte, bool error) // Called from ISR
+{
+    /* Previous frame not processed yet - drop, host retries on missing response */
+    if (ctx.frame_ready)
+        return;
+
+    uint16_t now = hal_system_timer_get();
+
+    if ((uint16_t)(now - ctx.last_rx_time) > COMMUNICATION_MANAGER_RX_TIMEOUT_MS)
+        serial_protocol_parser_reset(&ctx.parser);
+
+    ctx.last_rx_time = now;
+
+    if (error)
+    {
+        serial_protocol_parser_reset(&ctx.parser);
+        return;
+    }
+
+    if (serial_protocol_parse(&ctx.parser, byte) == SERIAL_PROTOCOL_STATUS_FRAME_RECEIVED)
+        ctx.frame_ready = true;
+}
+
+//------------------------------------------------------------------------------
+
 bool communication_manager_init(void)
 {
+    serial_protocol_parser_reset(&ctx.parser);
+
     return true;
 }
 
@@ -35,12 +431,53 @@ void communication_manager_process(void)
 {
     if (event_get() & EVENT_SEND_TIME_INFO_REQ)
     {
-        event_send_time_req_data_t *time = event_get_data(EVENT_SEND_TIME_INFO_REQ);
-
-        hal_send_time_info(time);
+        send_frame(SERIAL_PROTOCOL_TYPE_TIME_INFO, event_get_data(EVENT_SEND_TIME_INFO_REQ), sizeof(event_send_time_req_data_t));
 
         event_clear(EVENT_SEND_TIME_INFO_REQ);
     }
+
+    if (event_get() & EVENT_SEND_DIAG_INFO_REQ)
+    {
+        if (ctx.diag_stream)
+            send_frame(SERIAL_PROTOCOL_TYPE_DIAG, event_get_data(EVENT_SEND_DIAG_INFO_REQ), sizeof(event_send_diag_req_data_t));
+
+        event_clear(EVENT_SEND_DIAG_INFO_REQ);
+    }
+
+    uint8_t capture[SERIAL_PROTOCOL_MAX_PAYLOAD];
+    uint8_t capture_len = radio_manager_capture_read(capture, sizeof(capture));
+
+    if (capture_len)
+        send_frame(SERIAL_PROTOCOL_TYPE_CAPTURE, capture, capture_len);
+
+    if (ctx.frame_ready)
+    {
+        /* Any valid frame confirms that host follows new baud rate */
+        ctx.baudrate_unconfirmed = false;
+
+        process_frame(&ctx.parser.frame);
+
+        if (ctx.pending_baudrate)
+        {
+            /* Response is already sent with previous baud rate, parser is still locked by frame_ready */
+            hal_serial_set_baudrate(ctx.pending_baudrate);
+            serial_protocol_parser_reset(&ctx.parser);
+
+            ctx.pending_baudrate = 0;
+            ctx.baudrate_unconfirmed = true;
+            ctx.baudrate_switch_time = hal_system_timer_get();
+        }
+
+        ctx.frame_ready = false;
+    }
+
+    if (ctx.baudrate_unconfirmed && (uint16_t)(hal_system_timer_get() - ctx.baudrate_switch_time) >= COMMUNICATION_MANAGER_BAUDRATE_CONFIRM_MS)
+    {
+        /* Host lost - fall back to baud rate it can find after reset */
+        hal_serial_reset_baudrate();
+
+        ctx.baudrate_unconfirmed = false;
+    }
 }
 
 //------------------------------------------------------------------------------
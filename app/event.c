@@ -27,12 +27,13 @@
 
 struct event_ctx
 {
-    uint8_t event_buf;
+    uint16_t event_buf;
     event_sync_time_status_data_t sync_time_status_data;
     event_update_time_req_data_t update_time_data;
     event_set_time_req_data_t set_time_data;
     event_set_alarm_req_data_t set_alarm_data;
     event_set_timezone_req_data_t timezone_buf;
+    event_set_dst_req_data_t set_dst_data;
 };
 
 static struct event_ctx ctx;
@@ -69,6 +70,12 @@ void *event_get_data(enum event_type event)
     if (event == EVENT_SEND_TIME_INFO_REQ)
         return &ctx.update_time_data;
 
+    if (event == EVENT_SEND_DIAG_INFO_REQ)
+        return &ctx.sync_time_status_data;
+
+    if (event == EVENT_SET_DST_REQ)
+        return &ctx.set_dst_data;
+
     return NULL; // No data available for the event
 }
 
@@ -29,7 +29,7 @@ extern "C" {
 
 #include <stdint.h>
 
-#include <hal.h> /* Do not duplicate struct ds1307_time and hal_timestamp */
+#include <hal.h> /* Do not duplicate struct ds1307_time and hal_alarm */
 
 //------------------------------------------------------------------------------
 
@@ -43,6 +43,8 @@ enum event_type
     EVENT_SET_ALARM_REQ = 1 << 5,
     EVENT_ALARM_REQ = 1 << 6,
     EVENT_SEND_TIME_INFO_REQ = 1 << 7,
+    EVENT_SEND_DIAG_INFO_REQ = 1 << 8,
+    EVENT_SET_DST_REQ = 1 << 9,
 };
 
 enum event_sync_time_status
@@ -51,6 +53,7 @@ enum event_sync_time_status
     EVENT_SYNC_TIME_STATUS_FRAME_STARTED,
     EVENT_SYNC_TIME_STATUS_ERROR,
     EVENT_SYNC_TIME_STATUS_SYNCED,
+    EVENT_SYNC_TIME_STATUS_UNCONFIRMED,     /* Valid frame, waiting for confirmation by next one */
 };
 
 struct event_sync_time_status_data
@@ -60,14 +63,32 @@ struct event_sync_time_status_data
     uint16_t time_ms;
     uint8_t dcf_output;
     enum event_sync_time_status status;
+    uint8_t confidence;     /* Confidence of last valid frame [%], time is set when it reaches confirmation level */
+    uint8_t quality;        /* Signal quality score of recent pulses [%] */
+};
+
+/* Daylight saving time state received with DCF77 time */
+struct event_set_dst_req_data
+{
+    uint8_t dst;                /* CEST (bit 17) */
+    uint8_t change_announced;   /* Change at the end of current hour (bit 16) */
+};
+
+/* Alarm to store, index first - the same layout as serial protocol payload */
+struct event_set_alarm_req_data
+{
+    uint8_t id;
+    struct hal_alarm alarm;
 };
 
 typedef struct event_sync_time_status_data event_sync_time_status_data_t;
 typedef struct ds1307_time event_update_time_req_data_t;
 typedef struct ds1307_time event_set_time_req_data_t;
 typedef int8_t event_set_timezone_req_data_t; 
-typedef struct hal_timestamp event_set_alarm_req_data_t;
+typedef struct event_set_alarm_req_data event_set_alarm_req_data_t;
 typedef struct ds1307_time event_send_time_req_data_t;
+typedef struct event_sync_time_status_data event_send_diag_req_data_t;
+typedef struct event_set_dst_req_data event_set_dst_req_data_t;
 
 //------------------------------------------------------------------------------
 
@@ -22,6 +22,8 @@
 
 #include <hal.h>
 
+#include <scheduler.h>
+
 #include <radio_manager.h>
 #include <clock_manager.h>
 #include <communication_manager.h>
@@ -29,6 +31,40 @@
 
 //------------------------------------------------------------------------------
 
+enum main_task_id
+{
+    MAIN_TASK_ID_CLOCK,
+    MAIN_TASK_ID_RADIO,
+    MAIN_TASK_ID_COMMUNICATION,
+    MAIN_TASK_ID_UI,
+
+    MAIN_TASK_ID_MAX,
+};
+
+/* Clock Manager handles second tick and time requests as they come (period 0) and goes first, so time fetch waits
+   at most for one task in progress. Radio Manager period is shorter than the shortest decoded segment (glitches
+   are merged by decoder), so no segment status is skipped. Serial frames are parsed in RX ISR and locked until
+   processed. UI task repaints on events at most at 20 Hz, encoder and button input is dispatched by HAL on every pass. */
+static const struct scheduler_task tasks[MAIN_TASK_ID_MAX] = 
+{
+    /*                                  task                            period_ms   budget_ms   priority */
+    [MAIN_TASK_ID_CLOCK]            = {clock_manager_process,           0,          10,         3},
+    [MAIN_TASK_ID_RADIO]            = {radio_manager_process,           20,         5,          2},
+    [MAIN_TASK_ID_COMMUNICATION]    = {communication_manager_process,   20,         10,         1},
+    [MAIN_TASK_ID_UI]               = {ui_manager_process,              50,         50,         0},
+};
+
+static const struct scheduler_cfg scheduler_cfg = 
+{
+    .tasks = tasks,
+    .tasks_count = MAIN_TASK_ID_MAX,
+    .get_time = hal_system_timer_get,
+    .task_begin = hal_profiler_task_begin,
+    .task_end = hal_profiler_task_end,
+};
+
+//------------------------------------------------------------------------------
+
 int main()
 {
     hal_init();
@@ -37,6 +73,8 @@ int main()
     clock_manager_init();
     communication_manager_init();
     ui_manager_init();
+
+    scheduler_init(&scheduler_cfg);
     
     while (1)
     {
@@ -44,10 +82,7 @@ int main()
         hal_process();
 
         /* Main logic */
-        radio_manager_process();
-        clock_manager_process();
-        communication_manager_process();
-        ui_manager_process();
+        scheduler_process();
     }
 }
 
@@ -22,23 +22,63 @@
 
 #include <stddef.h>
 
+#include <util/atomic.h>
+
 #include <event.h>
 
 #include <dcf77_decoder.h>
+#include <dcf77_capture.h>
+#include <civil_time.h>
 
 #include <hal.h>
 
 //------------------------------------------------------------------------------
 
+/* Confirmation policy - parity covers 35 data bits with 3 bits only, so frame time is committed to RTC when confidence
+   reaches given level: single frame gives 50 %, each consecutive frame exactly one minute later adds 25 %
+   and agreement with RTC synchronized before adds 25 % (default - two consecutive frames or one frame matching RTC),
+   frame with bits repaired by decoder loses 25 % */
+#ifndef RADIO_MANAGER_MIN_CONFIDENCE
+#define RADIO_MANAGER_MIN_CONFIDENCE 75
+#endif
+
+#ifndef RADIO_MANAGER_RTC_TOLERANCE_S
+#define RADIO_MANAGER_RTC_TOLERANCE_S 120UL     /* RTC drift between synchronizations, 0 disables RTC agreement */
+#endif
+
+#define RADIO_MANAGER_CONFIDENCE_STEP 25
+#define RADIO_MANAGER_CONFIDENCE_MAX 100
+#define RADIO_MANAGER_DCF77_TIME_ZONE 1         /* CET, CEST is UTC+2 */
+
+//------------------------------------------------------------------------------
+
+_Static_assert(RADIO_MANAGER_ERROR_FIELDS == DCF77_DECODER_ERROR_MAX - 1, "Error stats do not match decoder errors");
+
+//------------------------------------------------------------------------------
+
 struct radio_manager_ctx
 {
     volatile bool synced;
     volatile enum dcf77_decoder_status decoder_status;
     volatile enum dcf77_decoder_status prev_decoder_status;
     volatile bool triggered_on_bit;
-    volatile bool prev_triggered_on_bit;
+    volatile bool glitch;
+    volatile bool redecoded;            /* Last segment replaced status of the one split by glitch */
+    volatile uint8_t pulse_seq;         /* Incremented with every decoded segment */
+    uint8_t processed_pulse_seq;
     volatile uint16_t last_time_ms;
     volatile uint8_t bit_number;
+    volatile uint8_t quality;           /* Decoder quality score [%] */
+    struct radio_manager_stats stats;
+    struct radio_manager_error_stats error_stats;
+    bool pending_started;               /* Outcome of last segment - counted when it cannot be merged anymore */
+    bool pending_lost;
+    enum dcf77_decoder_error pending_error;
+    uint32_t prev_frame_utc;            /* Time of previous valid frame [s since 2000-01-01 UTC] */
+    uint8_t consecutive_frames;         /* Valid frames one minute apart, including previous one */
+    bool rtc_synced;                    /* RTC was set from confirmed frame since reset */
+    volatile bool capture_enabled;
+    struct dcf77_capture capture;
 };
 
 static struct radio_manager_ctx ctx;
@@ -49,24 +89,133 @@ static struct radio_manager_ctx ctx;
 
 void hal_dcf_cb(uint16_t ms, bool triggred_on_bit) // Called from ISR
 {
-    if (ctx.synced)
+    if (ctx.synced && !ctx.capture_enabled)
         return;
 
-    ctx.triggered_on_bit = triggred_on_bit;
-    ctx.last_time_ms = ms;
+    enum dcf77_decoder_status status = dcf77_decode(ms, triggred_on_bit);
+
+    if (status == DCF77_DECODER_STATUS_GLITCH)
+    {
+        ctx.glitch = !ctx.glitch;
+    }
+    else
+    {
+        /* Segment split by odd number of glitches was decoded again - its status replaces the previous one */
+        ctx.redecoded = ctx.glitch && triggred_on_bit == ctx.triggered_on_bit;
+
+        if (!ctx.redecoded)
+            ctx.prev_decoder_status = ctx.decoder_status;
+
+        ctx.glitch = false;
+        ctx.triggered_on_bit = triggred_on_bit;
+        ctx.last_time_ms = ms;
+        ctx.decoder_status = status;
+        ctx.bit_number = dcf77_decoder_get_bit_count();
+        ctx.pulse_seq++;
+    }
 
-    ctx.prev_decoder_status = ctx.decoder_status;
+    ctx.quality = dcf77_decoder_get_quality()->score >> 8;
 
-    ctx.decoder_status = dcf77_decode(ms, triggred_on_bit);
-    
-    if (ctx.decoder_status == DCF77_DECODER_STATUS_BIT_RECEIVED)
-        ctx.bit_number++;
-    else if (ctx.decoder_status != DCF77_DECODER_STATUS_BREAK_RECEIVED)
-        ctx.bit_number = 0;
+    if (ctx.capture_enabled)
+        dcf77_capture_push(&ctx.capture, ms, triggred_on_bit, status, ctx.bit_number);
 };
 
 //------------------------------------------------------------------------------
 
+/* Segment status may still be replaced after glitch (e.g. break split by spike gives period error first) */
+static void count_pending_segment(void)
+{
+    if (ctx.pending_started)
+        ctx.stats.frames_started++;
+
+    if (ctx.pending_lost)
+    {
+        ctx.stats.errors++;
+
+        if (ctx.pending_error != DCF77_DECODER_ERROR_NONE)
+            ctx.error_stats.fields[ctx.pending_error - 1]++;
+
+        ctx.error_stats.last_error = ctx.pending_error;
+    }
+}
+
+static void frame_get_time(const uint8_t *dcf_frame, event_set_time_req_data_t *time)
+{
+    time->seconds = 0;
+    time->minutes = 10 * DCF77_DECODER_FRAME_GET_MINUTES_TENS(dcf_frame) + DCF77_DECODER_FRAME_GET_MINUTES_UNITS(dcf_frame);
+    time->hours = 10 * DCF77_DECODER_FRAME_GET_HOURS_TENS(dcf_frame) + DCF77_DECODER_FRAME_GET_HOURS_UNITS(dcf_frame);
+    time->day = DCF77_DECODER_FRAME_GET_WEEKDAY(dcf_frame);
+    time->date = 10 * DCF77_DECODER_FRAME_GET_DAY_TENS(dcf_frame) + DCF77_DECODER_FRAME_GET_DAY_UNITS(dcf_frame);
+    time->month = 10 * DCF77_DECODER_FRAME_GET_MONTH_TENS(dcf_frame) + DCF77_DECODER_FRAME_GET_MONTH_UNITS(dcf_frame);
+    time->year = 10 * DCF77_DECODER_FRAME_GET_YEAR_TENS(dcf_frame) + DCF77_DECODER_FRAME_GET_YEAR_UNITS(dcf_frame);
+}
+
+static uint8_t frame_confidence(const uint8_t *dcf_frame)
+{
+    struct ds1307_time time;
+
+    frame_get_time(dcf_frame, &time);
+
+    /* Compared in UTC, so frames around DST change are still one minute apart (bits 17-18: 01 - CEST) */
+    bool cest = DCF77_DECODER_FRAME_GET_WINTER_TIME(dcf_frame) == 0x01;
+    uint32_t utc = civil_time_epoch_add(civil_time_to_epoch((struct civil_time *)&time), -(RADIO_MANAGER_DCF77_TIME_ZONE + cest) * 3600L);
+
+    if (utc != ctx.prev_frame_utc + 60)
+        ctx.consecutive_frames = 1;
+    else if (ctx.consecutive_frames < RADIO_MANAGER_CONFIDENCE_MAX / RADIO_MANAGER_CONFIDENCE_STEP)
+        ctx.consecutive_frames++;
+
+    ctx.prev_frame_utc = utc;
+
+    uint8_t confidence = RADIO_MANAGER_CONFIDENCE_STEP * (ctx.consecutive_frames + 1);
+
+    /* Erasures are repaired with parity, which leaves no margin for detection of other bit errors */
+    if (dcf77_decoder_get_frame_erasures())
+        confidence -= RADIO_MANAGER_CONFIDENCE_STEP;
+
+#if RADIO_MANAGER_RTC_TOLERANCE_S
+    /* RTC keeps UTC, its second 0 is about to come as well */
+    if (ctx.rtc_synced && hal_get_time(&time))
+    {
+        uint32_t rtc = civil_time_to_epoch((struct civil_time *)&time);
+
+        if ((rtc > utc ? rtc - utc : utc - rtc) <= RADIO_MANAGER_RTC_TOLERANCE_S)
+            confidence += RADIO_MANAGER_CONFIDENCE_STEP;
+    }
+#endif
+
+    return confidence > RADIO_MANAGER_CONFIDENCE_MAX ? RADIO_MANAGER_CONFIDENCE_MAX : confidence;
+}
+
+static void commit_frame(const uint8_t *dcf_frame)
+{
+    frame_get_time(dcf_frame, event_get_data(EVENT_SET_TIME_REQ));
+
+    event_set(EVENT_SET_TIME_REQ);
+
+    /* Bits 17-18: 01 - CEST, 10 - CET, other values are not trusted */
+    uint8_t zone = DCF77_DECODER_FRAME_GET_WINTER_TIME(dcf_frame);
+
+    if (zone == 0x01 || zone == 0x02)
+    {
+        event_set_dst_req_data_t *set_dst_req_data = event_get_data(EVENT_SET_DST_REQ);
+
+        set_dst_req_data->dst = (zone == 0x01);
+        set_dst_req_data->change_announced = DCF77_DECODER_FRAME_GET_TIME_CHANGE_ANN(dcf_frame);
+
+        event_set(EVENT_SET_DST_REQ);
+    }
+
+    if (!ctx.capture_enabled)
+        hal_dcf_power_down(true);
+
+    ctx.synced = true;
+    ctx.rtc_synced = true;
+    ctx.stats.frames_synced++;
+}
+
+//------------------------------------------------------------------------------
+
 bool radio_manager_init(void)
 {
     ctx.synced = true;
@@ -79,20 +228,28 @@ void radio_manager_process(void)
     if (event_get() & EVENT_SYNC_TIME_REQ)
     {
         ctx.synced = false;
+        ctx.stats.sync_requests++;
+
+        event_sync_time_status_data_t *sync_time_status_data = event_get_data(EVENT_SYNC_TIME_STATUS);
+
+        sync_time_status_data->confidence = 0;
 
         hal_dcf_power_down(false);
 
         event_clear(EVENT_SYNC_TIME_REQ);
     }
 
-    if (!ctx.synced && ctx.prev_triggered_on_bit != ctx.triggered_on_bit)
+    if (!ctx.synced && ctx.processed_pulse_seq != ctx.pulse_seq)
     {
+        ctx.processed_pulse_seq = ctx.pulse_seq;
+
         event_sync_time_status_data_t *sync_time_status_data = event_get_data(EVENT_SYNC_TIME_STATUS);
         
         sync_time_status_data->bit_number = ctx.bit_number;
         sync_time_status_data->triggred_on_bit = ctx.triggered_on_bit;
         sync_time_status_data->time_ms = ctx.last_time_ms;
         sync_time_status_data->dcf_output = hal_dcf_get_state();
+        sync_time_status_data->quality = ctx.quality;
 
         if (ctx.decoder_status == DCF77_DECODER_STATUS_WAITING)
             sync_time_status_data->status = EVENT_SYNC_TIME_STATUS_WAITING; 
@@ -101,33 +258,94 @@ void radio_manager_process(void)
         else if (ctx.decoder_status == DCF77_DECODER_STATUS_ERROR)
             sync_time_status_data->status = EVENT_SYNC_TIME_STATUS_ERROR;  
 
-        event_set(EVENT_SYNC_TIME_STATUS);
+        /* Counted here - main loop sees every decoded segment (glitches are not counted) */
+        ctx.stats.pulses++;
+        ctx.stats.bit_number = ctx.bit_number;
+        ctx.stats.decoder_status = ctx.decoder_status;
+
+        /* Minute mark inside frame starts the next one at once - the interrupted frame is lost as well */
+        bool frame_lost = ctx.decoder_status == DCF77_DECODER_STATUS_ERROR ||
+                          (ctx.decoder_status == DCF77_DECODER_STATUS_FRAME_STARTED && ctx.prev_decoder_status == DCF77_DECODER_STATUS_BIT_RECEIVED);
+
+        /* Minute mark completing frame from bits received before it starts the next frame as well */
+        bool minute_mark_synced = ctx.decoder_status == DCF77_DECODER_STATUS_SYNCED && !ctx.triggered_on_bit;
+
+        /* Previous segment is final unless this one replaced it */
+        if (!ctx.redecoded)
+            count_pending_segment();
+
+        ctx.pending_started = ctx.decoder_status == DCF77_DECODER_STATUS_FRAME_STARTED || minute_mark_synced;
+        ctx.pending_lost = frame_lost;
+        ctx.pending_error = dcf77_decoder_get_error();
 
-        if (ctx.decoder_status == DCF77_DECODER_STATUS_FRAME_STARTED && ctx.prev_decoder_status == DCF77_DECODER_STATUS_SYNCED)
+        event_set(EVENT_SYNC_TIME_STATUS | EVENT_SEND_DIAG_INFO_REQ);
+
+        /* Frame is completed by minute mark - second 0 starts now */
+        if ((ctx.decoder_status == DCF77_DECODER_STATUS_FRAME_STARTED && ctx.prev_decoder_status == DCF77_DECODER_STATUS_SYNCED) || minute_mark_synced)
         {
+            const uint8_t *dcf_frame = (const uint8_t *)dcf77_get_frame();
+
             sync_time_status_data->dcf_output = true;
-            sync_time_status_data->status = EVENT_SYNC_TIME_STATUS_SYNCED;
-            
-            event_set_time_req_data_t *set_time_req_data = event_get_data(EVENT_SET_TIME_REQ);
-            
-            uint8_t *dcf_frame = (uint8_t*)dcf77_get_frame();
-            
-            set_time_req_data->seconds = 0;
-            set_time_req_data->minutes = 10 * DCF77_DECODER_FRAME_GET_MINUTES_TENS(dcf_frame) + DCF77_DECODER_FRAME_GET_MINUTES_UNITS(dcf_frame);
-            set_time_req_data->hours = 10 * DCF77_DECODER_FRAME_GET_HOURS_TENS(dcf_frame) + DCF77_DECODER_FRAME_GET_HOURS_UNITS(dcf_frame);
-            set_time_req_data->date = 10 * DCF77_DECODER_FRAME_GET_DAY_TENS(dcf_frame) + DCF77_DECODER_FRAME_GET_DAY_UNITS(dcf_frame);
-            set_time_req_data->month = 10 * DCF77_DECODER_FRAME_GET_MONTH_TENS(dcf_frame) + DCF77_DECODER_FRAME_GET_MONTH_UNITS(dcf_frame);
-            set_time_req_data->year = 10 * DCF77_DECODER_FRAME_GET_YEAR_TENS(dcf_frame) + DCF77_DECODER_FRAME_GET_YEAR_UNITS(dcf_frame);
-
-            event_set(EVENT_SET_TIME_REQ);
-
-            hal_dcf_power_down(true);
-
-            ctx.synced = true;
+            sync_time_status_data->confidence = frame_confidence(dcf_frame);
+
+            if (sync_time_status_data->confidence >= RADIO_MANAGER_MIN_CONFIDENCE)
+            {
+                sync_time_status_data->status = EVENT_SYNC_TIME_STATUS_SYNCED;
+
+                commit_frame(dcf_frame);
+            }
+            else
+            {
+                /* Receiver stays powered for next frame */
+                sync_time_status_data->status = EVENT_SYNC_TIME_STATUS_UNCONFIRMED;
+            }
         }
 
-        ctx.prev_triggered_on_bit = ctx.triggered_on_bit;
     }
 }
 
+const struct radio_manager_error_stats *radio_manager_get_error_stats(void)
+{
+    return &ctx.error_stats;
+}
+
+void radio_manager_get_quality(struct dcf77_decoder_quality *quality)
+{
+    /* Updated by decoder in ISR */
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *quality = *dcf77_decoder_get_quality();
+    }
+}
+
+void radio_manager_set_capture(bool enable)
+{
+    if (enable && !ctx.capture_enabled)
+    {
+        dcf77_capture_init(&ctx.capture);
+        hal_dcf_power_down(false);
+    }
+    else if (!enable && ctx.synced)
+    {
+        hal_dcf_power_down(true);
+    }
+
+    ctx.capture_enabled = enable;
+}
+
+uint8_t radio_manager_capture_read(uint8_t *data, uint8_t max)
+{
+    if (!ctx.capture_enabled)
+        return 0;
+
+    return dcf77_capture_read(&ctx.capture, data, max);
+}
+
+const struct radio_manager_stats *radio_manager_get_stats(void)
+{
+    ctx.stats.sync_active = !ctx.synced;
+
+    return &ctx.stats;
+}
+
 //------------------------------------------------------------------------------
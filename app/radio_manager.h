@@ -28,6 +28,32 @@ extern "C" {
 //------------------------------------------------------------------------------
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#include <dcf77_decoder.h> /* Do not duplicate struct dcf77_decoder_quality */
+
+//------------------------------------------------------------------------------
+
+struct radio_manager_stats
+{
+    uint16_t pulses;            /* Pulses seen by main loop during synchronization */
+    uint16_t frames_started;
+    uint16_t frames_synced;
+    uint16_t errors;
+    uint16_t sync_requests;
+    uint8_t bit_number;         /* Current bit number in frame */
+    uint8_t decoder_status;     /* Last decoder status @ref enum dcf77_decoder_status */
+    uint8_t sync_active;        /* Receiver is powered and decoding */
+};
+
+#define RADIO_MANAGER_ERROR_FIELDS 6
+
+/* Frames rejected by decoder by failing field, index is decoder error code - 1 */
+struct radio_manager_error_stats
+{
+    uint16_t fields[RADIO_MANAGER_ERROR_FIELDS];    /* Pulse, marker, minutes, hours, date, period */
+    uint8_t last_error;                             /* Last decoder error @ref enum dcf77_decoder_error */
+};
 
 //------------------------------------------------------------------------------
 
@@ -39,6 +65,30 @@ bool radio_manager_init(void);
 /// @note This function should be called in the main loop
 void radio_manager_process(void);
 
+/// @brief Gets decoder statistics counted since reset
+/// @return pointer to statistics structure @ref struct radio_manager_stats
+const struct radio_manager_stats *radio_manager_get_stats(void);
+
+/// @brief Gets decoder errors by failing field counted since reset
+/// @return pointer to statistics structure @ref struct radio_manager_error_stats
+const struct radio_manager_error_stats *radio_manager_get_error_stats(void);
+
+/// @brief Gets signal quality metrics of DCF77 decoder
+/// @note Metrics are updated with every pulse while receiver is powered, score is also sent with sync status event
+/// @param quality output structure pointer @ref struct dcf77_decoder_quality
+void radio_manager_get_quality(struct dcf77_decoder_quality *quality);
+
+/// @brief Enables or disables raw pulse capture
+/// @note Receiver stays powered while capture is enabled, every pulse is recorded (also after synchronization)
+/// @param enable true for enable, false for disable
+void radio_manager_set_capture(bool enable);
+
+/// @brief Reads captured pulses encoded as dcf77_capture byte stream
+/// @param data output buffer pointer
+/// @param max output buffer size
+/// @return number of bytes read
+uint8_t radio_manager_capture_read(uint8_t *data, uint8_t max);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
@@ -31,6 +31,9 @@
 
 #define UI_MANAGER_CHAR_BUF_LEN                         (15)
 
+#define UI_MANAGER_CHAR_FULL_BLOCK                      ('\xFF') /* HD44780 character ROM */
+#define UI_MANAGER_QUALITY_BAR_LEN                      (4)
+
 //------------------------------------------------------------------------------
 
 #define UI_ALARM_BPM                                    (1000UL)
@@ -84,9 +87,9 @@
 #define UI_ITEM_OFFSET_DATE_D                           offsetof(event_set_time_req_data_t, date)
 #define UI_ITEM_OFFSET_DATE_M                           offsetof(event_set_time_req_data_t, month)
 #define UI_ITEM_OFFSET_DATE_Y                           offsetof(event_set_time_req_data_t, year)
-#define UI_ITEM_OFFSET_ALARM_EN                         offsetof(event_set_alarm_req_data_t, is_enabled)
-#define UI_ITEM_OFFSET_ALARM_H                          offsetof(event_set_alarm_req_data_t, hours)
-#define UI_ITEM_OFFSET_ALARM_M                          offsetof(event_set_alarm_req_data_t, minutes)
+#define UI_ITEM_OFFSET_ALARM_EN                         offsetof(struct hal_alarm, is_enabled)
+#define UI_ITEM_OFFSET_ALARM_H                          offsetof(struct hal_alarm, hours)
+#define UI_ITEM_OFFSET_ALARM_M                          offsetof(struct hal_alarm, minutes)
 #define UI_ITEM_OFFSET_TIMEZONE                         0
 #define UI_ITEM_OFFSET_SYNC                             0
 #define UI_ITEM_OFFSET_ESC                              0
@@ -111,8 +114,11 @@
 #define UI_ITEM_POS_SYNC_STATUS_IS_SYNCED_COL           (14)
     
 #define UI_ITEM_POS_SYNC_STATUS_TIME_ROW                (0)
-#define UI_ITEM_POS_SYNC_STATUS_BIT_TIME_COL            (3)
-#define UI_ITEM_POS_SYNC_STATUS_BREAK_TIME_COL          (8)
+#define UI_ITEM_POS_SYNC_STATUS_BIT_TIME_COL            (2)
+#define UI_ITEM_POS_SYNC_STATUS_BREAK_TIME_COL          (7)
+
+#define UI_ITEM_POS_SYNC_STATUS_QUALITY_ROW             (0)
+#define UI_ITEM_POS_SYNC_STATUS_QUALITY_COL             (12)
     
 #define UI_ITEM_POS_SYNC_STATUS_BIT_NUMBER_ROW          (1)
 #define UI_ITEM_POS_SYNC_STATUS_BIT_NUMBER_COL          (3)
@@ -187,7 +193,7 @@ struct ui_manager_ctx
 
 static struct ui_manager_ctx ctx; 
 
-static const uint8_t items[UI_MANAGER_ITEM_ID_MAX][UI_MANAGER_ITEM_PROPERTY_MAX] = 
+static const uint8_t items[UI_MANAGER_ITEM_ID_MAX][UI_MANAGER_ITEM_PROPERTY_MAX] PROGMEM = 
 {
     [UI_MANAGER_ITEM_ID_TIME_H]       = {UI_ITEM_POS_TIME_H,      UI_ITEM_TIME_H_MIN,        UI_ITEM_TIME_H_MAX,        UI_ITEM_OFFSET_TIME_H},
     [UI_MANAGER_ITEM_ID_TIME_M]       = {UI_ITEM_POS_TIME_M,      UI_ITEM_TIME_M_MIN,        UI_ITEM_TIME_M_MAX,        UI_ITEM_OFFSET_TIME_M},
@@ -203,7 +209,7 @@ static const uint8_t items[UI_MANAGER_ITEM_ID_MAX][UI_MANAGER_ITEM_PROPERTY_MAX]
     [UI_MANAGER_ITEM_ID_OK]           = {UI_ITEM_POS_OK,          UI_ITEM_DUMMY_MIN,         UI_ITEM_DUMMY_MAX,         UI_ITEM_OFFSET_OK},
 };
 
-static struct buzzer_note alarm_beep[] = 
+static const struct buzzer_note alarm_beep[] PROGMEM = 
 {
 	{BUZZER_TONE_C6, BUZZER_NOTE_QUARTER},
 	{BUZZER_TONE_STOP, BUZZER_NOTE_QUARTER},
@@ -218,33 +224,62 @@ static struct buzzer_note alarm_beep[] =
 
 //------------------------------------------------------------------------------
 
+static uint8_t item_get_property(enum ui_manager_item_id item_id, enum ui_manager_item_property property)
+{
+    return pgm_read_byte(&items[item_id][property]);
+}
+
 static void item_id_update(int8_t diff)
 {
     ctx.item_id += diff;
     ctx.item_id = (ctx.item_id + UI_MANAGER_ITEM_ID_MAX) % UI_MANAGER_ITEM_ID_MAX;
 }
 
-static int8_t item_limit_value(int8_t val, int8_t min, int8_t max)
+static int8_t item_limit_value(int16_t val, int8_t min, int8_t max)
 {
-    if (val < min) 
-        return max;
-    if (val > max) 
-        return min;
-    
-    return val;
+    /* Wrap around the range, so accelerated steps keep their distance past the end */
+    int16_t range = max - min + 1;
+
+    val = (val - min) % range;
+
+    if (val < 0)
+        val += range;
+
+    return val + min;
+}
+
+static void ui_load_alarm(void)
+{
+    event_set_alarm_req_data_t *req = (event_set_alarm_req_data_t *)event_get_data(EVENT_SET_ALARM_REQ);
+
+    req->id = 0;
+    hal_get_alarm(req->id, &req->alarm);
+}
+
+static struct hal_alarm *ui_get_alarm(void)
+{
+    event_set_alarm_req_data_t *req = (event_set_alarm_req_data_t *)event_get_data(EVENT_SET_ALARM_REQ);
+
+    /* Only the first alarm is shown and edited, others are set via serial protocol - reload after such request is handled */
+    if (req->id != 0 && !(event_get() & EVENT_SET_ALARM_REQ))
+        ui_load_alarm();
+
+    return &req->alarm;
 }
 
 static void item_update(enum ui_manager_item_id item_id, int8_t val)
 {
     event_set_time_req_data_t *time = (event_set_time_req_data_t *)event_get_data(EVENT_SET_TIME_REQ);
-    event_set_alarm_req_data_t *alarm = (event_set_alarm_req_data_t *)event_get_data(EVENT_SET_ALARM_REQ);
+    struct hal_alarm *alarm = ui_get_alarm();
     int8_t *timezone = event_get_data(EVENT_SET_TIMEZONE_REQ);
 
     uint8_t *item_buf_ptrs[] = {(uint8_t*)time, (uint8_t*)alarm, (uint8_t*)timezone};
 
     uint8_t buf_idx = (item_id >= UI_MANAGER_ITEM_ID_ALARM_EN) + (item_id == UI_MANAGER_ITEM_ID_TIMEZONE);
 
-    item_buf_ptrs[buf_idx][items[item_id][UI_MANAGER_ITEM_PROPERTY_OFFSET]] = item_limit_value((item_buf_ptrs[buf_idx][items[item_id][UI_MANAGER_ITEM_PROPERTY_OFFSET]]) + val, items[item_id][UI_MANAGER_ITEM_PROPERTY_MIN_VALUE], items[item_id][UI_MANAGER_ITEM_PROPERTY_MAX_VALUE]);
+    uint8_t offset = item_get_property(item_id, UI_MANAGER_ITEM_PROPERTY_OFFSET);
+
+    item_buf_ptrs[buf_idx][offset] = item_limit_value((int8_t)item_buf_ptrs[buf_idx][offset] + val, item_get_property(item_id, UI_MANAGER_ITEM_PROPERTY_MIN_VALUE), item_get_property(item_id, UI_MANAGER_ITEM_PROPERTY_MAX_VALUE));
 }
 
 //------------------------------------------------------------------------------
@@ -254,13 +289,15 @@ static void ui_alarm_play(bool play)
     if (!play) 
         hal_audio_stop(); 
 
-    hal_audio_set_pattern(play ? alarm_beep : NULL, sizeof(alarm_beep), UI_ALARM_BPM);
+    hal_audio_set_pattern_P(play ? alarm_beep : NULL, sizeof(alarm_beep), UI_ALARM_BPM);
     hal_led_set(play);
 }
 
 static void ui_print_cursor(void)
 {
-    hal_lcd_set_cursor(items[ctx.item_id][UI_MANAGER_ITEM_PROPERTY_POS] / 16, items[ctx.item_id][UI_MANAGER_ITEM_PROPERTY_POS] % 16);
+    uint8_t pos = item_get_property(ctx.item_id, UI_MANAGER_ITEM_PROPERTY_POS);
+
+    hal_lcd_set_cursor(pos / 16, pos % 16);
 }
 
 static void ui_print_static_icons(void)
@@ -295,7 +332,7 @@ static void ui_print_time(struct ds1307_time *unix_time)
     hal_lcd_print(ctx.buf, UI_ITEM_POS_TIME_STRING_ROW, UI_ITEM_POS_TIME_STRING_COL);
 }
 
-static void ui_print_alarm(struct hal_timestamp *alarm)
+static void ui_print_alarm(struct hal_alarm *alarm)
 {
     uint8_t i = 0;
 
@@ -330,7 +367,7 @@ static void ui_print_sync_status(event_sync_time_status_data_t *sync_time_status
 {
     if (!full)
     {
-        hal_lcd_print(sync_time_status_data->status == EVENT_SYNC_TIME_STATUS_SYNCED ? "OK" : "--", UI_ITEM_POS_SYNC_STATUS_IS_SYNCED_ROW, UI_ITEM_POS_SYNC_STATUS_IS_SYNCED_COL);
+        hal_lcd_print_P(sync_time_status_data->status == EVENT_SYNC_TIME_STATUS_SYNCED ? PSTR("OK") : PSTR("--"), UI_ITEM_POS_SYNC_STATUS_IS_SYNCED_ROW, UI_ITEM_POS_SYNC_STATUS_IS_SYNCED_COL);
         return;
     }
 
@@ -350,15 +387,31 @@ static void ui_print_sync_status(event_sync_time_status_data_t *sync_time_status
 
     hal_lcd_print(ctx.buf, UI_ITEM_POS_SYNC_STATUS_BIT_NUMBER_ROW, UI_ITEM_POS_SYNC_STATUS_BIT_NUMBER_COL);
 
-    static const char *status_str_tab[] = 
+    /* Signal quality bar - one block per 25 % */
+    uint8_t blocks = (sync_time_status_data->quality * UI_MANAGER_QUALITY_BAR_LEN + 50) / 100;
+
+    for (i = 0; i < UI_MANAGER_QUALITY_BAR_LEN; i++)
+        ctx.buf[i] = i < blocks ? UI_MANAGER_CHAR_FULL_BLOCK : '_';
+    ctx.buf[i] = 0;
+
+    hal_lcd_print(ctx.buf, UI_ITEM_POS_SYNC_STATUS_QUALITY_ROW, UI_ITEM_POS_SYNC_STATUS_QUALITY_COL);
+
+    static const char status_waiting_str[] PROGMEM = "WAITING";
+    static const char status_started_str[] PROGMEM = "STARTED";
+    static const char status_error_str[] PROGMEM = "ERROR  ";
+    static const char status_synced_str[] PROGMEM = "SYNCED ";
+    static const char status_unconfirmed_str[] PROGMEM = "CHECK  ";
+
+    static const char *const status_str_tab[] PROGMEM = 
     {
-        [EVENT_SYNC_TIME_STATUS_WAITING] = "WAITING",
-        [EVENT_SYNC_TIME_STATUS_FRAME_STARTED] = "STARTED",
-        [EVENT_SYNC_TIME_STATUS_ERROR] = "ERROR  ",
-        [EVENT_SYNC_TIME_STATUS_SYNCED] = "SYNCED ",
+        [EVENT_SYNC_TIME_STATUS_WAITING] = status_waiting_str,
+        [EVENT_SYNC_TIME_STATUS_FRAME_STARTED] = status_started_str,
+        [EVENT_SYNC_TIME_STATUS_ERROR] = status_error_str,
+        [EVENT_SYNC_TIME_STATUS_SYNCED] = status_synced_str,
+        [EVENT_SYNC_TIME_STATUS_UNCONFIRMED] = status_unconfirmed_str,
     };
 
-    hal_lcd_print(status_str_tab[sync_time_status_data->status], UI_ITEM_POS_SYNC_STATUS_STATE_ROW, UI_ITEM_POS_SYNC_STATUS_STATER_COL);
+    hal_lcd_print_P(pgm_read_ptr(&status_str_tab[sync_time_status_data->status]), UI_ITEM_POS_SYNC_STATUS_STATE_ROW, UI_ITEM_POS_SYNC_STATUS_STATER_COL);
 
     hal_led_set(!sync_time_status_data->dcf_output);
 }
@@ -369,7 +422,7 @@ static void ui_print_alarm_date_screen(bool set)
     
     ui_print_static_icons();
     ui_print_time(event_get_data(set ? EVENT_SET_TIME_REQ : EVENT_UPDATE_TIME_REQ));
-    ui_print_alarm(event_get_data(EVENT_SET_ALARM_REQ));
+    ui_print_alarm(ui_get_alarm());
     ui_print_timezone(event_get_data(EVENT_SET_TIMEZONE_REQ));
 
     if (set)
@@ -389,8 +442,8 @@ static void ui_print_time_sync_status_screen(void)
     hal_lcd_clear();
     hal_lcd_set_cursor_mode(false, false);
 
-    hal_lcd_print("T:     /     ms", UI_ITEM_POS_SYNC_STATUS_TIME_STRING_ROW, UI_ITEM_POS_SYNC_STATUS_TIME_STRING_COL);
-    hal_lcd_print("B:    S:", UI_ITEM_POS_SYNC_STATUS_BIT_STATE_STRING_ROW, UI_ITEM_POS_SYNC_STATUS_BIT_STATE_STRING_COL);
+    hal_lcd_print_P(PSTR("T:    /"), UI_ITEM_POS_SYNC_STATUS_TIME_STRING_ROW, UI_ITEM_POS_SYNC_STATUS_TIME_STRING_COL);
+    hal_lcd_print_P(PSTR("B:    S:"), UI_ITEM_POS_SYNC_STATUS_BIT_STATE_STRING_ROW, UI_ITEM_POS_SYNC_STATUS_BIT_STATE_STRING_COL);
 
     ui_print_sync_status(event_get_data(EVENT_SYNC_TIME_STATUS), true);
 }
@@ -403,7 +456,7 @@ static void ui_print_value_select_screen(void)
 //------------------------------------------------------------------------------
 /* HAL callbacks and structures */
 
-const uint8_t hal_user_defined_char_tab[6][8] = 
+const uint8_t hal_user_defined_char_tab[6][8] PROGMEM = 
 {
     [UI_MANAGER_CHAR_ID_CLOCK] = {0x0E, 0x0E, 0x15, 0x15, 0x13, 0x0E, 0x0E, 0x0E},
     [UI_MANAGER_CHAR_ID_ANTENNA] = {0x00, 0x15, 0x0A, 0x04, 0x04, 0x04, 0x04, 0x00},
@@ -413,7 +466,7 @@ const uint8_t hal_user_defined_char_tab[6][8] =
     [UI_MANAGER_CHAR_ID_ESCAPE] = {0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00, 0x00}
 };
 
-void hal_button_pressed_cb(void)
+static void ui_button_click(void)
 {
     switch (ctx.state)
     {
@@ -433,7 +486,7 @@ void hal_button_pressed_cb(void)
         if (ctx.item_id == UI_MANAGER_ITEM_ID_ESC)
         {
             /* Restore previous alarm and timezone value - could be replaced by copying using Clock Manager buffer pointer getters */
-            hal_get_alarm(event_get_data(EVENT_SET_ALARM_REQ));
+            ui_load_alarm();
             hal_get_timezone(event_get_data(EVENT_SET_TIMEZONE_REQ));
 
             ui_print_alarm_date_screen(false);
@@ -493,8 +546,121 @@ void hal_button_pressed_cb(void)
     }
 }
 
-void hal_encoder_rotation_cb(int8_t dir)
+static void ui_button_long_press(void)
 {
+    switch (ctx.state)
+    {
+    case UI_MANAGER_STATE_TIME_DATE_ALARM_DISPLAY:
+    case UI_MANAGER_STATE_SYNC_SATUS_DISPLAY:
+
+        /* Shortcut - force radio synchronization and watch its progress */
+        event_set(EVENT_SYNC_TIME_REQ);
+
+        ui_print_time_sync_status_screen();
+
+        ctx.state = UI_MANAGER_STATE_SYNC_SATUS_DISPLAY;
+
+        break;
+
+    case UI_MANAGER_STATE_VALUE_SELECT:
+
+        /* Hold to increment value - continued by repeat events */
+        item_update(ctx.item_id, 1);
+
+        ui_print_time(event_get_data(EVENT_SET_TIME_REQ));
+        ui_print_alarm(ui_get_alarm());
+        ui_print_timezone(event_get_data(EVENT_SET_TIMEZONE_REQ));
+
+        ui_print_cursor();
+
+        break;
+
+    case UI_MANAGER_STATE_ALARM:
+
+        ui_button_click();
+
+        break;
+
+    default:
+
+        break;
+    }
+}
+
+static void ui_button_double_click(void)
+{
+    switch (ctx.state)
+    {
+    case UI_MANAGER_STATE_TIME_DATE_ALARM_DISPLAY:
+    {
+        /* Shortcut - toggle alarm without entering settings */
+        struct hal_alarm *alarm = ui_get_alarm();
+
+        alarm->is_enabled = !alarm->is_enabled;
+
+        event_set(EVENT_SET_ALARM_REQ);
+
+        ui_print_alarm(alarm);
+
+        break;
+    }
+
+    case UI_MANAGER_STATE_TIME_DATE_ALARM_SET:
+    case UI_MANAGER_STATE_VALUE_SELECT:
+
+        /* In settings it is just two clicks */
+        ui_button_click();
+        ui_button_click();
+
+        break;
+
+    default:
+
+        ui_button_click();
+
+        break;
+    }
+}
+
+void hal_button_event_cb(enum button_event event)
+{
+    switch (event)
+    {
+    case BUTTON_EVENT_CLICK:
+
+        ui_button_click();
+
+        break;
+
+    case BUTTON_EVENT_DOUBLE_CLICK:
+
+        ui_button_double_click();
+
+        break;
+
+    case BUTTON_EVENT_LONG_PRESS:
+
+        ui_button_long_press();
+
+        break;
+
+    case BUTTON_EVENT_REPEAT:
+
+        if (ctx.state == UI_MANAGER_STATE_VALUE_SELECT)
+            ui_button_long_press();
+
+        break;
+
+    default:
+
+        break;
+    }
+}
+
+void hal_encoder_rotation_cb(int8_t steps)
+{
+    int8_t dir = (steps > 0) ? 1 : -1;
+
     switch (ctx.state)
     {
     case UI_MANAGER_STATE_TIME_DATE_ALARM_DISPLAY:
@@ -515,10 +681,10 @@ void hal_encoder_rotation_cb(int8_t dir)
 
     case UI_MANAGER_STATE_VALUE_SELECT:
 
-        item_update(ctx.item_id, dir);
+        item_update(ctx.item_id, steps);
 
         ui_print_time(event_get_data(EVENT_SET_TIME_REQ));
-        ui_print_alarm(event_get_data(EVENT_SET_ALARM_REQ));
+        ui_print_alarm(ui_get_alarm());
         ui_print_timezone(event_get_data(EVENT_SET_TIMEZONE_REQ));
 
         ui_print_cursor();
@@ -544,7 +710,7 @@ void hal_encoder_rotation_cb(int8_t dir)
 bool ui_manager_init(void)
 {
     /* It could be replaced by using event / getter from Clock Manager to remove HAL dependency */
-    hal_get_alarm(event_get_data(EVENT_SET_ALARM_REQ));
+    ui_load_alarm();
     hal_get_timezone(event_get_data(EVENT_SET_TIMEZONE_REQ));
 
     ui_print_alarm_date_screen(false);
@@ -573,6 +739,10 @@ void ui_manager_process(void)
             ui_print_time(event_get_data(EVENT_UPDATE_TIME_REQ));
             ui_print_sync_status(event_get_data(EVENT_SYNC_TIME_STATUS), false);
 
+            /* Alarm and timezone can be changed remotely via serial protocol */
+            ui_print_alarm(ui_get_alarm());
+            ui_print_timezone(event_get_data(EVENT_SET_TIMEZONE_REQ));
+
             event_clear(EVENT_UPDATE_TIME_REQ);
         }
 
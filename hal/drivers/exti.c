@@ -24,6 +24,8 @@
 
 #include <avr/interrupt.h>
 
+#include <profiler.h>
+
 //------------------------------------------------------------------------------
 
 struct exti_context
@@ -183,40 +185,60 @@ else if (id == EXTI_ID_INT1)
 #if EXTI_USE_INT0_ISR
 ISR(INT0_vect)
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_INT0_ISR);
+
     if (ctx.int0_cb)
         ctx.int0_cb();
+
+    PROFILER_ISR_END(PROFILER_ID_INT0_ISR);
 }
 #endif
 
 #if EXTI_USE_INT1_ISR
 ISR(INT1_vect)
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_INT1_ISR);
+
     if (ctx.int1_cb)
         ctx.int1_cb();
+
+    PROFILER_ISR_END(PROFILER_ID_INT1_ISR);
 }
 #endif
 
 #if EXTI_USE_PCINT0_ISR
 ISR(PCINT0_vect) // PCINT[7:0]
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_PCINT0_ISR);
+
     if (ctx.pcint0_cb)
         ctx.pcint0_cb();
+
+    PROFILER_ISR_END(PROFILER_ID_PCINT0_ISR);
 }
 #endif
 
 #if EXTI_USE_PCINT1_ISR
 ISR(PCINT1_vect) // PCINT[14:8]
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_PCINT1_ISR);
+
     if (ctx.pcint1_cb)
         ctx.pcint1_cb();
+
+    PROFILER_ISR_END(PROFILER_ID_PCINT1_ISR);
 }
 #endif
 
 #if EXTI_USE_PCINT2_ISR
 ISR(PCINT2_vect) // PCINT[23:16]
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_PCINT2_ISR);
+
     if (ctx.pcint2_cb)
         ctx.pcint2_cb();
+
+    PROFILER_ISR_END(PROFILER_ID_PCINT2_ISR);
 }
 #endif
 
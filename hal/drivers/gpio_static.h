@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#ifndef GPIO_STATIC_H_
+#define GPIO_STATIC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <avr/io.h>
+
+#include <gpio.h>
+
+//------------------------------------------------------------------------------
+
+/* Compile-time GPIO binding - port and pin have to be compile-time constants (e.g. HAL_*_PORT / HAL_*_PIN),
+   then every access is folded to single sbi / cbi / sbic / sbis instruction, which is atomic by itself.
+   With runtime arguments functions still work, but generate more code than gpio.c equivalents. */
+
+#define GPIO_STATIC_INLINE static inline __attribute__((always_inline))
+
+//------------------------------------------------------------------------------
+
+GPIO_STATIC_INLINE volatile uint8_t *gpio_static_port_reg(enum gpio_port port)
+{
+    return (port == GPIO_PORT_B) ? &PORTB : (port == GPIO_PORT_C) ? &PORTC : &PORTD;
+}
+
+GPIO_STATIC_INLINE volatile uint8_t *gpio_static_ddr_reg(enum gpio_port port)
+{
+    return (port == GPIO_PORT_B) ? &DDRB : (port == GPIO_PORT_C) ? &DDRC : &DDRD;
+}
+
+GPIO_STATIC_INLINE volatile uint8_t *gpio_static_pin_reg(enum gpio_port port)
+{
+    return (port == GPIO_PORT_B) ? &PINB : (port == GPIO_PORT_C) ? &PINC : &PIND;
+}
+
+//------------------------------------------------------------------------------
+
+/// @brief Initializes selected GPIO pin (compile-time bound equivalent of @ref gpio_init)
+/// @param port selected GPIO port @ref enum gpio_port
+/// @param pin selected GPIO pin @ref enum gpio_pin
+/// @param dir true for output, false for input
+/// @param pull_up true for pull-up resistor enabling (valid only for input)
+GPIO_STATIC_INLINE void gpio_static_init(enum gpio_port port, enum gpio_pin pin, bool dir, bool pull_up)
+{
+    if (dir)
+    {
+        *gpio_static_ddr_reg(port) |= (1 << pin);
+        return;
+    }
+
+    *gpio_static_ddr_reg(port) &= ~(1 << pin);
+
+    if (pull_up)
+    {
+        *gpio_static_port_reg(port) |= (1 << pin);
+        MCUCR &= ~(1 << PUD);
+    }
+    else
+        *gpio_static_port_reg(port) &= ~(1 << pin);
+}
+
+/// @brief Set given output value (compile-time bound equivalent of @ref gpio_set)
+/// @param port selected GPIO port @ref enum gpio_port
+/// @param pin selected GPIO pin @ref enum gpio_pin
+/// @param value true for high state, false for low state
+GPIO_STATIC_INLINE void gpio_static_set(enum gpio_port port, enum gpio_pin pin, bool value)
+{
+    if (value)
+        *gpio_static_port_reg(port) |= (1 << pin);
+    else
+        *gpio_static_port_reg(port) &= ~(1 << pin);
+}
+
+/// @brief Toggles output value to opposite than actual (compile-time bound equivalent of @ref gpio_toggle)
+/// @param port selected GPIO port @ref enum gpio_port
+/// @param pin selected GPIO pin @ref enum gpio_pin
+GPIO_STATIC_INLINE void gpio_static_toggle(enum gpio_port port, enum gpio_pin pin)
+{
+    *gpio_static_pin_reg(port) = (1 << pin);
+}
+
+/// @brief Gets actual pin state (compile-time bound equivalent of @ref gpio_get)
+/// @param port selected GPIO port @ref enum gpio_port
+/// @param pin selected GPIO pin @ref enum gpio_pin
+/// @return actual pin state
+GPIO_STATIC_INLINE bool gpio_static_get(enum gpio_port port, enum gpio_pin pin)
+{
+    return !!(*gpio_static_pin_reg(port) & (1 << pin));
+}
+
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GPIO_STATIC_H_ */
+
+//------------------------------------------------------------------------------
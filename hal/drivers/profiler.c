@@ -0,0 +1,219 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#include "profiler.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include <util/atomic.h>
+
+#include <timer.h>
+
+//------------------------------------------------------------------------------
+
+#if PROFILER_USE_PROFILING && (TIMER_USE_TIMER1_COMPA_ISR || TIMER_USE_TIMER1_COMPB_ISR || TIMER_USE_TIMER1_CAPT_ISR)
+#error "Timer1 is reserved for cycle counting in profiling build"
+#endif
+
+#if PROFILER_USE_PROFILING && !TIMER_USE_TIMER1_OVF_ISR
+#error "Task cycle counter is extended by Timer1 overflow interrupt in profiling build"
+#endif
+
+//------------------------------------------------------------------------------
+
+#if PROFILER_USE_CONTEXT
+volatile uint8_t profiler_context __attribute__((section(".noinit")));
+#endif
+
+#if PROFILER_USE_PROFILING
+struct profiler_ctx
+{
+    struct profiler_stats stats[PROFILER_ID_MAX];
+    uint32_t task_start_cycles;
+    volatile uint16_t overflows;    /* Upper half of task cycle counter, wraps after ~71 min at 1 MHz */
+};
+
+static struct profiler_ctx ctx;
+
+static struct timer_obj timer1_obj;
+
+static void timer1_ovf_cb(void)
+{
+    ctx.overflows++;
+}
+
+static uint32_t get_cycles(void)
+{
+    uint16_t low;
+    uint16_t high;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        low = TCNT1;
+        high = ctx.overflows;
+
+        /* Overflow pending while interrupts are disabled - counter value read after it is small */
+        if ((TIFR1 & (1 << TOV1)) && low < 0x8000)
+            high++;
+    }
+
+    return ((uint32_t)high << 16) | low;
+}
+#endif
+
+//------------------------------------------------------------------------------
+
+void profiler_init(void)
+{
+#if PROFILER_USE_PROFILING
+    static struct timer_cfg timer1_cfg =
+    {
+        .id = TIMER_ID_1,
+        .clock = TIMER_CLOCK_NO_PRESC,
+        .async_clock = TIMER_ASYNC_CLOCK_DISABLED,
+        .mode = TIMER_MODE_16_BIT_NORMAL,
+        .com_a_cfg = TIMER_CM_DISABLED,
+        .com_b_cfg = TIMER_CM_DISABLED,
+
+        .counter_val = 0,
+        .ovrfv_cb = timer1_ovf_cb,
+
+        .out_comp_a_val = 0,
+        .out_comp_b_val = 0,
+        .out_comp_a_cb = NULL,
+        .out_comp_b_cb = NULL,
+
+        .input_capture_val = 0,
+        .input_capture_pullup = false,
+        .input_capture_noise_canceler = false,
+        .input_capture_rising_edge = false,
+        .in_capt_cb = NULL,
+    };
+
+    profiler_reset();
+
+    timer_init(&timer1_obj, &timer1_cfg);
+    timer_start(&timer1_obj, true);
+#endif
+}
+
+void profiler_record(enum profiler_id id, uint32_t cycles)
+{
+#if PROFILER_USE_PROFILING
+    if (id >= PROFILER_ID_MAX)
+        return;
+
+    struct profiler_stats *stats = &ctx.stats[id];
+
+    if (stats->count == UINT16_MAX || stats->sum_cycles > UINT32_MAX - cycles)
+    {
+        stats->count >>= 1;
+        stats->sum_cycles >>= 1;
+    }
+
+    if (stats->count == 0 || cycles < stats->min_cycles)
+        stats->min_cycles = cycles;
+
+    if (cycles > stats->max_cycles)
+        stats->max_cycles = cycles;
+
+    stats->count++;
+    stats->sum_cycles += cycles;
+#endif
+    (void)id;
+    (void)cycles;
+}
+
+void profiler_task_begin(uint8_t task_id)
+{
+#if PROFILER_USE_CONTEXT
+    profiler_context = PROFILER_ID_TASK_0 + task_id;
+#endif
+#if PROFILER_USE_PROFILING
+    ctx.task_start_cycles = get_cycles();
+#endif
+    (void)task_id;
+}
+
+void profiler_task_end(uint8_t task_id)
+{
+#if PROFILER_USE_CONTEXT
+    profiler_context = PROFILER_CONTEXT_IDLE;
+#endif
+#if PROFILER_USE_PROFILING
+    uint32_t cycles = get_cycles() - ctx.task_start_cycles;
+
+    if (task_id >= PROFILER_TASKS_COUNT)
+        return;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        profiler_record(PROFILER_ID_TASK_0 + task_id, cycles);
+    }
+#endif
+    (void)task_id;
+}
+
+bool profiler_get_stats(enum profiler_id id, struct profiler_stats *stats)
+{
+#if PROFILER_USE_PROFILING
+    if (id >= PROFILER_ID_MAX || !stats)
+        return false;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *stats = ctx.stats[id];
+    }
+
+    return true;
+#endif
+    (void)id;
+    (void)stats;
+    return false;
+}
+
+void profiler_reset(void)
+{
+#if PROFILER_USE_PROFILING
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        memset(ctx.stats, 0x00, sizeof(ctx.stats));
+    }
+#endif
+}
+
+void profiler_set_context(uint8_t context)
+{
+#if PROFILER_USE_CONTEXT
+    profiler_context = context;
+#endif
+    (void)context;
+}
+
+uint8_t profiler_get_context(void)
+{
+#if PROFILER_USE_CONTEXT
+    return profiler_context;
+#endif
+    return PROFILER_CONTEXT_IDLE;
+}
+
+//------------------------------------------------------------------------------
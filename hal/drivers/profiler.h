@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+#ifndef PROFILER_USE_PROFILING
+#define PROFILER_USE_PROFILING 0
+#endif
+
+#ifndef PROFILER_USE_CONTEXT
+#define PROFILER_USE_CONTEXT 0
+#endif
+
+#ifndef PROFILER_TASKS_COUNT
+#define PROFILER_TASKS_COUNT 6
+#endif
+
+/* Context values outside @ref enum profiler_id */
+#define PROFILER_CONTEXT_INIT 0xFE  /* Initialization before main loop */
+#define PROFILER_CONTEXT_IDLE 0xFF  /* Main loop outside of tasks */
+
+//------------------------------------------------------------------------------
+
+#if PROFILER_USE_CONTEXT
+
+extern volatile uint8_t profiler_context;
+
+/* Id of running ISR or task is kept in .noinit, so it is still known after watchdog reset */
+#define PROFILER_CONTEXT_BEGIN(id) uint8_t profiler_prev_context = profiler_context; profiler_context = (id)
+#define PROFILER_CONTEXT_END() profiler_context = profiler_prev_context
+
+#else
+
+#define PROFILER_CONTEXT_BEGIN(id) (void)0
+#define PROFILER_CONTEXT_END() (void)0
+
+#endif
+
+#if PROFILER_USE_PROFILING
+
+#include <avr/io.h>
+
+/* Timer1 is free-running with no prescaler, so TCNT1 counts CPU cycles (wraps after 65536 cycles) */
+/* Plain TCNT1 read is safe in ISR only - ISRs are not nested and share TEMP register with main loop,
+   ISRs are far shorter than 65536 cycles, so overflow counter used for tasks is not needed */
+#define PROFILER_ISR_BEGIN(id) PROFILER_CONTEXT_BEGIN(id); uint16_t profiler_start_cycles = TCNT1
+#define PROFILER_ISR_END(id) profiler_record((id), (uint16_t)(TCNT1 - profiler_start_cycles)); PROFILER_CONTEXT_END()
+
+#else
+
+#define PROFILER_ISR_BEGIN(id) PROFILER_CONTEXT_BEGIN(id)
+#define PROFILER_ISR_END(id) PROFILER_CONTEXT_END()
+
+#endif
+
+//------------------------------------------------------------------------------
+
+enum profiler_id
+{
+    PROFILER_ID_INT0_ISR,
+    PROFILER_ID_INT1_ISR,
+    PROFILER_ID_PCINT0_ISR,
+    PROFILER_ID_PCINT1_ISR,
+    PROFILER_ID_PCINT2_ISR,
+    PROFILER_ID_TIMER0_OVF_ISR,
+    PROFILER_ID_TIMER0_COMPA_ISR,
+    PROFILER_ID_TIMER0_COMPB_ISR,
+    PROFILER_ID_TIMER2_OVF_ISR,
+    PROFILER_ID_TIMER2_COMPA_ISR,
+    PROFILER_ID_TIMER2_COMPB_ISR,
+    PROFILER_ID_TWI_ISR,
+    PROFILER_ID_USART_RX_ISR,
+    PROFILER_ID_USART_TX_ISR,
+    PROFILER_ID_USART_UDRE_ISR,
+    PROFILER_ID_TASK_0,
+
+    PROFILER_ID_MAX = PROFILER_ID_TASK_0 + PROFILER_TASKS_COUNT,
+};
+
+//------------------------------------------------------------------------------
+
+struct profiler_stats
+{
+    uint16_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint32_t sum_cycles;
+};
+
+//------------------------------------------------------------------------------
+
+/// @brief Initializes Timer1 as free-running CPU cycle counter and resets statistics
+/// @note Timer1 cannot be used by application in profiling build, its overflow interrupt extends task cycle counter
+///       to 32 bits (TIMER_USE_TIMER1_OVF_ISR required)
+void profiler_init(void);
+
+/// @brief Records single measurement
+/// @note When count or sum saturates, both are halved so mean value stays valid
+/// @param id measured code section id @ref enum profiler_id
+/// @param cycles measured execution time in CPU cycles
+void profiler_record(enum profiler_id id, uint32_t cycles);
+
+/// @brief Starts measurement of main loop task (ISRs executed in the meantime are included)
+/// @param task_id task index (0 to PROFILER_TASKS_COUNT - 1)
+void profiler_task_begin(uint8_t task_id);
+
+/// @brief Ends measurement of main loop task started by @ref profiler_task_begin
+/// @param task_id task index (0 to PROFILER_TASKS_COUNT - 1)
+void profiler_task_end(uint8_t task_id);
+
+/// @brief Gets statistics of selected code section
+/// @param id measured code section id @ref enum profiler_id
+/// @param stats output statistics structure pointer
+/// @return true if statistics are available, otherwise false
+bool profiler_get_stats(enum profiler_id id, struct profiler_stats *stats);
+
+/// @brief Resets all statistics
+void profiler_reset(void);
+
+/// @brief Sets context of code executed outside of ISRs and tasks (e.g. PROFILER_CONTEXT_INIT)
+/// @param context context value @ref enum profiler_id, PROFILER_CONTEXT_INIT or PROFILER_CONTEXT_IDLE
+void profiler_set_context(uint8_t context);
+
+/// @brief Gets id of running ISR or task
+/// @note Right after reset it returns context from before reset (.noinit), until it is set again
+/// @return context value (PROFILER_CONTEXT_IDLE if context tracking is disabled)
+uint8_t profiler_get_context(void);
+
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROFILER_H_ */
+
+//------------------------------------------------------------------------------
@@ -27,6 +27,8 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
+#include <profiler.h>
+
 //------------------------------------------------------------------------------
 
 #ifndef TIMER_USE_TIMER0
@@ -398,30 +400,42 @@ void timer_deinit(struct timer_obj *obj)
 #if TIMER_USE_TIMER0_OVF_ISR
 ISR(TIMER0_OVF_vect)
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_TIMER0_OVF_ISR);
+
     if (ctx.timer_obj[TIMER_ID_0]->ovrfv_cb)
     {
         ctx.timer_obj[TIMER_ID_0]->ovrfv_cb();
     }
+
+    PROFILER_ISR_END(PROFILER_ID_TIMER0_OVF_ISR);
 }
 #endif
 
 #if TIMER_USE_TIMER0_COMPA_ISR
 ISR(TIMER0_COMPA_vect)
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_TIMER0_COMPA_ISR);
+
     if (ctx.timer_obj[TIMER_ID_0]->out_comp_a_cb)
     {
         ctx.timer_obj[TIMER_ID_0]->out_comp_a_cb();
     }
+
+    PROFILER_ISR_END(PROFILER_ID_TIMER0_COMPA_ISR);
 }
 #endif
 
 #if TIMER_USE_TIMER0_COMPB_ISR
 ISR(TIMER0_COMPB_vect)
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_TIMER0_COMPB_ISR);
+
     if (ctx.timer_obj[TIMER_ID_0]->comp_b_cb)
     {
         ctx.timer_obj[TIMER_ID_0]->comp_b_cb();
     }
+
+    PROFILER_ISR_END(PROFILER_ID_TIMER0_COMPB_ISR);
 }
 #endif
 
@@ -474,30 +488,42 @@ ISR(TIMER1_CAPT_vect)
 #if TIMER_USE_TIMER2_OVF_ISR
 ISR(TIMER2_OVF_vect)
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_TIMER2_OVF_ISR);
+
     if (ctx.timer_obj[TIMER_ID_2]->ovrfv_cb)
     {
         ctx.timer_obj[TIMER_ID_2]->ovrfv_cb();
     }
+
+    PROFILER_ISR_END(PROFILER_ID_TIMER2_OVF_ISR);
 }
 #endif
 
 #if TIMER_USE_TIMER2_COMPA_ISR
 ISR(TIMER2_COMPA_vect)
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_TIMER2_COMPA_ISR);
+
     if (ctx.timer_obj[TIMER_ID_2]->out_comp_a_cb)
     {
         ctx.timer_obj[TIMER_ID_2]->out_comp_a_cb();
     }
+
+    PROFILER_ISR_END(PROFILER_ID_TIMER2_COMPA_ISR);
 }
 #endif
 
 #if TIMER_USE_TIMER2_COMPB_ISR
 ISR(TIMER2_COMPB_vect)
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_TIMER2_COMPB_ISR);
+
     if (ctx.timer_obj[TIMER_ID_2]->comp_b_cb)
     {
         ctx.timer_obj[TIMER_ID_2]->comp_b_cb();
     }
+
+    PROFILER_ISR_END(PROFILER_ID_TIMER2_COMPB_ISR);
 }
 #endif
 
@@ -506,6 +532,7 @@ ISR(TIMER2_COMPB_vect)
 struct system_timer_ctx
 {
     volatile uint16_t current_ms;
+    system_timer_tick_cb tick_cb;
 };
 
 static struct system_timer_ctx system_timer_ctx;
@@ -513,6 +540,9 @@ static struct system_timer_ctx system_timer_ctx;
 static void timer0_comp_a_cb(void)
 {
     system_timer_ctx.current_ms++; 
+
+    if (system_timer_ctx.tick_cb)
+        system_timer_ctx.tick_cb();
 }
 
 //------------------------------------------------------------------------------
@@ -568,4 +598,12 @@ bool system_timer_timeout_passed(uint16_t tickstamp, uint16_t timeout)
     return tickstamp + timeout < system_timer_get();
 }
 
+void system_timer_set_tick_cb(system_timer_tick_cb cb)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        system_timer_ctx.tick_cb = cb;
+    }
+}
+
 //------------------------------------------------------------------------------
@@ -42,6 +42,7 @@ extern "C" {
 typedef void (*timer_ovrf_cb)(void);
 typedef void (*timer_comp_cb)(void);
 typedef void (*timer_capt_cb)(uint16_t icr);
+typedef void (*system_timer_tick_cb)(void);
 
 //------------------------------------------------------------------------------
 
@@ -188,6 +189,11 @@ uint16_t system_timer_get(void);
 /// @return true if timeout passed
 bool system_timer_timeout_passed(uint16_t tickstamp, uint16_t timeout);
 
+/// @brief Registers callback called from system timer interrupt every 1 ms
+/// @note Callback runs in ISR context and has to be short, NULL unregisters
+/// @param cb tick callback pointer @ref system_timer_tick_cb
+void system_timer_set_tick_cb(system_timer_tick_cb cb);
+
 //------------------------------------------------------------------------------
 
 
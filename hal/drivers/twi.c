@@ -23,8 +23,22 @@
 #include <string.h>
 
 #include <util/twi.h>
+#include <util/delay.h>
 #include <avr/interrupt.h>
 
+#include <profiler.h>
+
+//------------------------------------------------------------------------------
+
+#define TWI_SDA_MASK (1 << PC4)
+#define TWI_SCL_MASK (1 << PC5)
+
+/* Busy-wait loop iteration: TWCR read, bit test, 16-bit counter decrement and branch */
+#define TWI_WAIT_LOOP_CYCLES 6
+#define TWI_TIMEOUT_LOOPS ((F_CPU / 1000000UL) * TWI_TIMEOUT_US / TWI_WAIT_LOOP_CYCLES)
+
+_Static_assert(TWI_TIMEOUT_LOOPS > 0 && TWI_TIMEOUT_LOOPS <= UINT16_MAX, "TWI timeout out of range");
+
 //------------------------------------------------------------------------------
 
 enum twi_state
@@ -52,43 +66,87 @@ static struct twi_ctx ctx;
 
 //------------------------------------------------------------------------------
 
-static void wait_for_transfer_complete(void)
+static bool wait_for_transfer_complete(void)
+{
+    uint16_t loops = TWI_TIMEOUT_LOOPS;
+
+    while (!(TWCR & (1 << TWINT)))
+    {
+        if (!--loops)
+            return false;
+    }
+
+    return true;
+}
+
+static bool generate_stop(void)
+{
+    TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN); 
+    
+    uint16_t loops = TWI_TIMEOUT_LOOPS;
+
+    while (TWCR & (1 << TWSTO))
+    {
+        if (!--loops)
+            return false;
+    }
+
+    return true;
+}
+
+/* Releases the bus after failed operation, hardware state machine is reset if it does not respond */
+static enum twi_status handle_blocking_error(enum twi_status status)
 {
-    while (!(TWCR & (1 << TWINT)));
+    if (status == TWI_STATUS_TIMEOUT || !generate_stop())
+    {
+        TWCR = 0;
+        TWCR = (1 << TWEN) | (1 << TWEA);
+
+        return TWI_STATUS_TIMEOUT;
+    }
+
+    return status;
 }
 
-static bool generate_start(void)
+static enum twi_status generate_start(void)
 {
     /* Generate START condition */
     TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
 
-    wait_for_transfer_complete();
+    if (!wait_for_transfer_complete())
+        return TWI_STATUS_TIMEOUT;
 
     if (TW_STATUS != TW_START) // START error
-        return false;
+        return TWI_STATUS_START_ERROR;
     
-    return true;
+    return TWI_STATUS_OK;
 }
 
-static bool send_slave_addr(uint8_t addr, bool read)
+static enum twi_status send_slave_addr(uint8_t addr, bool read)
 {
     TWDR = (addr & (read ? 0xFF : 0xFE));
 
     TWCR = (1 << TWINT) | (1 << TWEN);
 
-    wait_for_transfer_complete();
+    if (!wait_for_transfer_complete())
+        return TWI_STATUS_TIMEOUT;
 
     if (TW_STATUS != (read ? TW_MR_SLA_ACK : TW_MT_SLA_ACK)) // NACK error
-        return false;   
+        return TWI_STATUS_ADDR_NACK;   
 
-    return true;
+    return TWI_STATUS_OK;
 }
 
-static void generate_stop(void)
+static void line_release(uint8_t mask, uint8_t pull_ups)
 {
-    TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN); 
-    
-    while (TWCR & (1 << TWSTO));
+    DDRC &= ~mask;
+    PORTC |= (mask & pull_ups);
+}
+
+static void line_pull_down(uint8_t mask)
+{
+    PORTC &= ~mask;
+    DDRC |= mask;
 }
 
 #if TWI_USE_TWI_ISR
@@ -154,10 +212,10 @@ bool twi_init(struct twi_cfg *cfg)
     return true;
 }
 
-bool twi_send(uint8_t addr, uint8_t *data, uint8_t size, bool generate_stop_cond)
+enum twi_status twi_send(uint8_t addr, uint8_t *data, uint8_t size, bool generate_stop_cond)
 {
     if (!data || size == 0)
-        return false;
+        return TWI_STATUS_INVALID_ARG;
 
 #if TWI_USE_TWI_ISR
     /* Handle interrupt mode */
@@ -173,17 +231,21 @@ bool twi_send(uint8_t addr, uint8_t *data, uint8_t size, bool generate_stop_cond
         /* Generate START condition */
         TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
         
-        return true;
+        return TWI_STATUS_OK;
     }
 #endif
 
     /* Generate START condition */
-    if (!generate_start())
-        return false;
+    enum twi_status status = generate_start();
+
+    if (status != TWI_STATUS_OK)
+        return handle_blocking_error(status);
 
     /* Send slave address */
-    if (!send_slave_addr(addr, false))
-        return false;
+    status = send_slave_addr(addr, false);
+
+    if (status != TWI_STATUS_OK)
+        return handle_blocking_error(status);
 
     /* Send data */
     for (uint8_t i = 0; i < size; i++)
@@ -191,27 +253,28 @@ bool twi_send(uint8_t addr, uint8_t *data, uint8_t size, bool generate_stop_cond
         TWDR = data[i];
 
         if (TWCR & (1 << TWWC)) // Write collision error
-            return false;
+            return handle_blocking_error(TWI_STATUS_WRITE_COLLISION);
 
         TWCR = (1 << TWINT) | (1 << TWEN);
         
-        wait_for_transfer_complete();
+        if (!wait_for_transfer_complete())
+            return handle_blocking_error(TWI_STATUS_TIMEOUT);
 
         if (TW_STATUS != TW_MT_DATA_ACK) // NoACK error
-            return false;    
+            return handle_blocking_error(TWI_STATUS_DATA_NACK);    
     }
     
     /* Generate STOP condition */
-    if (generate_stop_cond)
-        generate_stop();
+    if (generate_stop_cond && !generate_stop())
+        return handle_blocking_error(TWI_STATUS_TIMEOUT);
 
-    return true;
+    return TWI_STATUS_OK;
 }
 
-bool twi_receive(uint8_t addr, uint8_t *data, uint8_t size)
+enum twi_status twi_receive(uint8_t addr, uint8_t *data, uint8_t size)
 {
     if (!data || size == 0)
-        return false;
+        return TWI_STATUS_INVALID_ARG;
 
 #if TWI_USE_TWI_ISR
     if (ctx.irq_mode)
@@ -226,17 +289,21 @@ bool twi_receive(uint8_t addr, uint8_t *data, uint8_t size)
         /* Generate START condition */
         TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
 
-        return true;
+        return TWI_STATUS_OK;
     }
 #endif
 
     /* Generate START condition */
-    if (!generate_start())
-        return false;
+    enum twi_status status = generate_start();
+
+    if (status != TWI_STATUS_OK)
+        return handle_blocking_error(status);
 
     /* Send slave address */
-    if (!send_slave_addr(addr, true))
-        return false;          
+    status = send_slave_addr(addr, true);
+
+    if (status != TWI_STATUS_OK)
+        return handle_blocking_error(status);
 
     /* Receive data */
     for (uint8_t i = 0; i < size; i++)
@@ -245,29 +312,69 @@ bool twi_receive(uint8_t addr, uint8_t *data, uint8_t size)
         {
             TWCR = (1 << TWEA) | (1 << TWINT) | (1 << TWEN);
             
-            wait_for_transfer_complete();
+            if (!wait_for_transfer_complete())
+                return handle_blocking_error(TWI_STATUS_TIMEOUT);
 
             if (TW_STATUS != TW_MR_DATA_ACK) // NoACK error
-                return false;
+                return handle_blocking_error(TWI_STATUS_DATA_NACK);
 
         }
         else /* Last byte */
         {
             TWCR = (1 << TWINT) | (1 << TWEN);
 
-            wait_for_transfer_complete();
+            if (!wait_for_transfer_complete())
+                return handle_blocking_error(TWI_STATUS_TIMEOUT);
 
             if (TW_STATUS != TW_MR_DATA_NACK) // NoNACK error
-                return false;
+                return handle_blocking_error(TWI_STATUS_DATA_NACK);
         }
 
         data[i] = TWDR;
     }
     
     /* Generate STOP condition */
-    generate_stop();
+    if (!generate_stop())
+        return handle_blocking_error(TWI_STATUS_TIMEOUT);
 
-    return true;
+    return TWI_STATUS_OK;
+}
+
+enum twi_status twi_bus_recover(void)
+{
+    uint8_t pull_ups = PORTC & (TWI_SDA_MASK | TWI_SCL_MASK);
+
+    /* Take pins over from TWI module, open-drain output is emulated with DDR */
+    TWCR = 0;
+
+    line_release(TWI_SDA_MASK | TWI_SCL_MASK, pull_ups);
+    _delay_us(TWI_RECOVERY_HALF_PERIOD_US);
+
+    /* Slave holding SDA low gets clocks until it finishes its byte (at most 8 data bits and ACK) */
+    for (uint8_t i = 0; i < 9 && !(PINC & TWI_SDA_MASK); i++)
+    {
+        line_pull_down(TWI_SCL_MASK);
+        _delay_us(TWI_RECOVERY_HALF_PERIOD_US);
+        line_release(TWI_SCL_MASK, pull_ups);
+        _delay_us(TWI_RECOVERY_HALF_PERIOD_US);
+    }
+
+    /* STOP condition - SDA rising edge while SCL is high resets slave state machine */
+    line_pull_down(TWI_SCL_MASK);
+    _delay_us(TWI_RECOVERY_HALF_PERIOD_US);
+    line_pull_down(TWI_SDA_MASK);
+    _delay_us(TWI_RECOVERY_HALF_PERIOD_US);
+    line_release(TWI_SCL_MASK, pull_ups);
+    _delay_us(TWI_RECOVERY_HALF_PERIOD_US);
+    line_release(TWI_SDA_MASK, pull_ups);
+    _delay_us(TWI_RECOVERY_HALF_PERIOD_US);
+
+    bool released = (PINC & (TWI_SDA_MASK | TWI_SCL_MASK)) == (TWI_SDA_MASK | TWI_SCL_MASK);
+
+    /* Enable TWI and set ACK bit generation */
+    TWCR = (1 << TWEN) | (1 << TWEA);
+
+    return released ? TWI_STATUS_OK : TWI_STATUS_BUS_ERROR;
 }
 
 bool twi_is_finished(bool *error)
@@ -302,7 +409,7 @@ void twi_deinit(void)
 //------------------------------------------------------------------------------
 
 #if TWI_USE_TWI_ISR
-ISR(TWI_vect)
+static void handle_irq(void)
 {
     switch (ctx.state)
     {
@@ -412,6 +519,15 @@ ISR(TWI_vect)
         break;
     }
 }
+
+ISR(TWI_vect)
+{
+    PROFILER_ISR_BEGIN(PROFILER_ID_TWI_ISR);
+
+    handle_irq();
+
+    PROFILER_ISR_END(PROFILER_ID_TWI_ISR);
+}
 #endif
 
 //------------------------------------------------------------------------------
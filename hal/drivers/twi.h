@@ -44,8 +44,30 @@ extern "C" {
 #define TWI_FIXED_SPEED 100000UL 
 #endif 
 
+/* Budget of single bus operation (START, byte, STOP) - byte takes 90 us at 100 kHz, rest is left for clock stretching */
+#ifndef TWI_TIMEOUT_US
+#define TWI_TIMEOUT_US 1000UL
+#endif
+
+/* SCL half period of bus recovery sequence (100 kHz) */
+#ifndef TWI_RECOVERY_HALF_PERIOD_US
+#define TWI_RECOVERY_HALF_PERIOD_US 5
+#endif
+
 //------------------------------------------------------------------------------
 
+enum twi_status
+{
+    TWI_STATUS_OK,
+    TWI_STATUS_INVALID_ARG,
+    TWI_STATUS_TIMEOUT,         /* Operation not finished in TWI_TIMEOUT_US - SCL held low or TWI module stuck */
+    TWI_STATUS_START_ERROR,     /* START not transmitted - bus busy or arbitration lost */
+    TWI_STATUS_ADDR_NACK,
+    TWI_STATUS_DATA_NACK,
+    TWI_STATUS_WRITE_COLLISION,
+    TWI_STATUS_BUS_ERROR,       /* Bus still held low after recovery sequence */
+};
+
 struct twi_cfg
 {
     bool pull_up_en;
@@ -69,15 +91,23 @@ bool twi_init(struct twi_cfg *cfg);
 /// @param data bytes to be transmitted
 /// @param size size of data to send
 /// @param generate_stop generate stop if no following read operation is expected
-/// @return true if sent successfully, otherwise false
-bool twi_send(uint8_t addr, uint8_t *data, uint8_t size, bool generate_stop_cond);
+/// @note Every bus operation is limited to TWI_TIMEOUT_US, STOP is generated on error to release the bus
+/// @return TWI_STATUS_OK if sent successfully, otherwise error code @ref enum twi_status
+enum twi_status twi_send(uint8_t addr, uint8_t *data, uint8_t size, bool generate_stop_cond);
 
 /// @brief Receives given amount of bytes under given address
 /// @param addr device address (r/w bit is set inside function)
 /// @param data bytes to be received
 /// @param size size of data to received
-/// @return true if sent successfully, otherwise false
-bool twi_receive(uint8_t addr, uint8_t *data, uint8_t size);
+/// @note Every bus operation is limited to TWI_TIMEOUT_US, STOP is generated on error to release the bus
+/// @return TWI_STATUS_OK if received successfully, otherwise error code @ref enum twi_status
+enum twi_status twi_receive(uint8_t addr, uint8_t *data, uint8_t size);
+
+/// @brief Releases bus held by slave (e.g. after reset in the middle of read transfer)
+/// @note TWI is disabled for the time of the sequence - SCL is clocked up to 9 times until SDA is released,
+///       then STOP is generated and TWI is enabled again, takes up to ~100 us
+/// @return TWI_STATUS_OK if both lines are high, otherwise TWI_STATUS_BUS_ERROR
+enum twi_status twi_bus_recover(void);
 
 /// @brief Checks if transmission is finished (for interrupt mode)
 /// @param error true if error occurred
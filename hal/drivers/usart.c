@@ -25,15 +25,15 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
+#include <profiler.h>
+
 //------------------------------------------------------------------------------
 
-#if USART_FIXED_BAUDRATE_DOUBLE_SPEED
-#define USART_FIXED_BAUDRATE_MUL 8UL
-#else
-#define USART_FIXED_BAUDRATE_MUL 16UL
-#endif
+#define USART_UBRR_VALUE USART_UBRR(F_CPU, USART_FIXED_BAUDRATE, USART_FIXED_BAUDRATE_DOUBLE_SPEED)
 
-#define USART_UBRR_VALUE ((F_CPU / (USART_FIXED_BAUDRATE_MUL * USART_FIXED_BAUDRATE)) - 1)
+#if USART_USE_FIXED_BAUDRATE && !USART_BAUDRATE_IS_VALID(F_CPU, USART_FIXED_BAUDRATE, USART_FIXED_BAUDRATE_DOUBLE_SPEED)
+#error "USART_FIXED_BAUDRATE error exceeds USART_MAX_BAUDRATE_ERROR_PERMILLE for given F_CPU and double speed setting"
+#endif
 
 //------------------------------------------------------------------------------
 
@@ -48,6 +48,9 @@ struct usart_context
 static struct usart_context ctx;
 #endif
 
+/* TXC0 is cleared before every write to UDR0, so it can be trusted only after first write */
+static volatile bool tx_started;
+
 //------------------------------------------------------------------------------
 
 bool usart_init(struct usart_cfg *cfg)
@@ -59,8 +62,8 @@ bool usart_init(struct usart_cfg *cfg)
     UBRR0H = (uint8_t)(USART_UBRR_VALUE >> 8);
     UBRR0L = (uint8_t)USART_UBRR_VALUE;
 #else
-    /* Set baud rate - alternative formula from mirekk36: (F_CPU + cfg->baudrate * 8) / (16UL * cfg->baudrate) - 1 */
-    uint16_t ubrr = F_CPU / ((cfg->double_speed ? 8 : 16) * cfg->baudrate) - 1;
+    /* Set baud rate - rounded to nearest (formula from mirekk36) */
+    uint16_t ubrr = USART_UBRR(F_CPU, cfg->baudrate, cfg->double_speed);
 
     UBRR0H = (uint8_t)(ubrr >> 8);
     UBRR0L = (uint8_t)ubrr;
@@ -155,8 +158,10 @@ void usart_send(uint8_t * data, uint8_t len)
         /* Wait for empty transmit buffer */
         while (!(UCSR0A & (1 << UDRE0)));
 
-        /* Put data into buffer, sends the data */
+        /* Clear transmit complete flag (written with one, error flags have to be written with zero) and put data into buffer */
+        UCSR0A = (UCSR0A & ((1 << U2X0) | (1 << MPCM0))) | (1 << TXC0);
         UDR0 = *data++;
+        tx_started = true;
     }
 }
 
@@ -192,6 +197,31 @@ void usart_print(char *str)
     usart_send((uint8_t*)str, strlen(str));
 }
 
+void usart_flush(void)
+{
+    if (!tx_started)
+        return;
+
+#if USART_USE_IRQ
+    /* Interrupt driven transmission in progress */
+    while (UCSR0B & (1 << UDRIE0));
+#endif
+
+    while (!(UCSR0A & (1 << TXC0)));
+}
+
+void usart_set_ubrr(uint16_t ubrr)
+{
+    usart_flush();
+
+    UBRR0H = (uint8_t)(ubrr >> 8);
+    UBRR0L = (uint8_t)ubrr;
+
+    /* Drop bytes received with previous baud rate */
+    while (UCSR0A & (1 << RXC0))
+        (void)UDR0;
+}
+
 void usart_deinit(void)
 {
     UCSR0A &= ~(1 << U2X0) & ~(1 << MPCM0);
@@ -201,6 +231,8 @@ void usart_deinit(void)
     UBRR0H = 0;
     UBRR0L = 0;
 
+    tx_started = false;
+
 #if USART_USE_IRQ
     memset(&ctx, 0x00, sizeof(ctx));
 #endif
@@ -210,26 +242,37 @@ void usart_deinit(void)
 
 #if USART_USE_IRQ
 ISR(USART_TX_vect)
-{ 
+{
+    PROFILER_ISR_BEGIN(PROFILER_ID_USART_TX_ISR);
+
     if (ctx.txc_cb)
         ctx.txc_cb();
+
+    PROFILER_ISR_END(PROFILER_ID_USART_TX_ISR);
 };
 
 ISR(USART_RX_vect)
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_USART_RX_ISR);
+
+    /* Error flags are valid until UDR0 is read */
+    volatile bool error = (UCSR0A & ((1 << FE0) | (1 << DOR0) | (1 << UPE0)));
     volatile uint8_t data_received = UDR0;
     volatile bool receive = false;
-    volatile bool error = (UCSR0A & ((1 << FE0) | (1 << DOR0) | (1 << UPE0)));
 
     if (ctx.rxc_cb)
         receive = ctx.rxc_cb(data_received, error);
 
     if (!receive)
         UCSR0B &= ~(1 << RXCIE0);
+
+    PROFILER_ISR_END(PROFILER_ID_USART_RX_ISR);
 };
 
 ISR(USART_UDRE_vect)
 {
+    PROFILER_ISR_BEGIN(PROFILER_ID_USART_UDRE_ISR);
+
     volatile uint8_t data_to_send = 0;
     volatile bool send = false;
 
@@ -237,9 +280,15 @@ ISR(USART_UDRE_vect)
         send = ctx.udre_cb(&data_to_send);
 
     if (send)
+    {
+        UCSR0A = (UCSR0A & ((1 << U2X0) | (1 << MPCM0))) | (1 << TXC0);
         UDR0 = data_to_send;
+        tx_started = true;
+    }
     else
         UCSR0B &= ~(1 << UDRIE0);
+
+    PROFILER_ISR_END(PROFILER_ID_USART_UDRE_ISR);
 };
 #endif
 
@@ -56,6 +56,27 @@ extern "C" {
 #define USART_FIXED_BAUDRATE 9600
 #endif
 
+#ifndef USART_MAX_BAUDRATE_ERROR_PERMILLE
+#define USART_MAX_BAUDRATE_ERROR_PERMILLE 20
+#endif
+
+//------------------------------------------------------------------------------
+
+/* Baud rate register value rounded to nearest - plain division truncates and can double the error */
+#define USART_UBRR(f_cpu, baudrate, double_speed) \
+    (((f_cpu) + ((double_speed) ? 4UL : 8UL) * (baudrate)) / (((double_speed) ? 8UL : 16UL) * (baudrate)) - 1)
+
+#define USART_ACTUAL_BAUDRATE(f_cpu, baudrate, double_speed) \
+    ((f_cpu) / (((double_speed) ? 8UL : 16UL) * (USART_UBRR(f_cpu, baudrate, double_speed) + 1)))
+
+/* Usable in #if and _Static_assert, e.g. 9600 at 1 MHz U2X: 0.2%, 19200: 7%, 38400: 8.5%, 31250 and 62500: exact */
+#define USART_BAUDRATE_ERROR_PERMILLE(f_cpu, baudrate, double_speed) \
+    ((USART_ACTUAL_BAUDRATE(f_cpu, baudrate, double_speed) > (baudrate) ? \
+      USART_ACTUAL_BAUDRATE(f_cpu, baudrate, double_speed) - (baudrate) : \
+      (baudrate) - USART_ACTUAL_BAUDRATE(f_cpu, baudrate, double_speed)) * 1000UL / (baudrate))
+
+#define USART_BAUDRATE_IS_VALID(f_cpu, baudrate, double_speed) \
+    (USART_BAUDRATE_ERROR_PERMILLE(f_cpu, baudrate, double_speed) <= USART_MAX_BAUDRATE_ERROR_PERMILLE)
 
 //------------------------------------------------------------------------------
 
@@ -158,6 +179,14 @@ bool usart_receive(uint8_t *data, uint32_t len);
 /// @param str - null-terminated string to send pointer
 void usart_print(char *str);
 
+/// @brief Waits until all written data is shifted out (returns immediately if nothing was sent since initialization)
+void usart_flush(void);
+
+/// @brief Changes baud rate without reinitialization (e.g. after baud rate negotiation)
+/// @note Pending transmission is completed with previous baud rate, receiver is flushed
+/// @param ubrr baud rate register value, e.g. USART_UBRR(F_CPU, baudrate, double_speed)
+void usart_set_ubrr(uint16_t ubrr);
+
 /// @brief Disables USART module, resets registers to default state and resets internal context
 void usart_deinit(void);
 
@@ -26,93 +26,107 @@
 #define BUTTON_USE_IRQ 0
 #endif
 
-#ifndef BUTTON_USE_POLLING
-#define BUTTON_USE_POLLING 0
-#endif
-
 //------------------------------------------------------------------------------
 
-#if BUTTON_USE_POLLING
-static bool process_poll(struct button_obj *obj)
+static bool time_passed(uint16_t now, uint16_t since, uint16_t period)
 {
-    bool state = obj->get_state();
+    /* Wrap-safe for periods shorter than 65 s */
+    return (uint16_t)(now - since) >= period;
+}
 
-    /* Check if debounce counter timed out */
-    if (obj->debounce_counter_current_value < obj->debounce_counter_initial_value)
+static void handle_edge(struct button_obj *obj, uint16_t now)
+{
+    if (obj->pressed)
     {
-        obj->debounce_counter_current_value++;
-        return obj->prev_state;
+        obj->press_time = now;
+        obj->long_press_reported = false;
+        obj->event(BUTTON_EVENT_PRESS);
+        return;
     }
-    
-    /* Check if button state has been changed */
-    if (state ^ obj->prev_state)
-    {
-         /* Check if button is in active state */
-        if (!state == obj->active_low)
-            obj->pressed();
 
-        obj->prev_state = state;
-        obj->debounce_counter_current_value = 0;
-        obj->autopress_counter_current_value = 0;
+    obj->event(BUTTON_EVENT_RELEASE);
+
+    /* Long press consumes the press, no click is reported on release */
+    if (obj->long_press_reported)
+        return;
+
+    if (obj->click_pending)
+    {
+        obj->click_pending = false;
+        obj->event(BUTTON_EVENT_DOUBLE_CLICK);
+    }
+    else if (obj->double_click_ms)
+    {
+        /* Click is reported when no second press comes within double click time */
+        obj->click_pending = true;
+        obj->release_time = now;
+    }
+    else
+    {
+        obj->event(BUTTON_EVENT_CLICK);
     }
-    /* Check if button state is still active */
-    else if (!state == obj->active_low)
+}
+
+static void handle_deadlines(struct button_obj *obj, uint16_t now)
+{
+    if (obj->pressed && obj->long_press_ms)
     {
-        if (obj->autopress_counter_current_value < obj->autopress_counter_initial_value)
+        if (!obj->long_press_reported)
         {
-            obj->autopress_counter_current_value++;
+            if (time_passed(now, obj->press_time, obj->long_press_ms))
+            {
+                /* Click before long press is not lost */
+                if (obj->click_pending)
+                {
+                    obj->click_pending = false;
+                    obj->event(BUTTON_EVENT_CLICK);
+                }
+
+                obj->long_press_reported = true;
+                obj->repeat_time = now;
+                obj->event(BUTTON_EVENT_LONG_PRESS);
+            }
         }
-        else
+        else if (obj->repeat_ms && time_passed(now, obj->repeat_time, obj->repeat_ms))
         {
-            obj->autopress_counter_current_value = 0;
-            obj->pressed();
+            obj->repeat_time += obj->repeat_ms;
+            obj->event(BUTTON_EVENT_REPEAT);
         }
     }
-
-    return state;
-}
-#endif
-
-#if BUTTON_USE_IRQ
-static bool process_irq(struct button_obj *obj)
-{
-    bool state = obj->get_state();
-
-    /* Check if button is in active state */
-    if (!state == obj->active_low)
-        obj->pressed();
-
-    return state;
+    else if (!obj->pressed && obj->click_pending && time_passed(now, obj->release_time, obj->double_click_ms))
+    {
+        obj->click_pending = false;
+        obj->event(BUTTON_EVENT_CLICK);
+    }
 }
-#endif
 
 //------------------------------------------------------------------------------
 
 bool button_init(struct button_obj *obj, struct button_cfg *cfg)
 {
-    if (!cfg || !cfg->init || !cfg->get_state || !cfg->pressed)
+    if (!obj || !cfg || !cfg->init || !cfg->get_state || !cfg->event || !cfg->get_time)
         return false;
 
     obj->init = cfg->init;
     obj->get_state = cfg->get_state;
-    obj->pressed = cfg->pressed;
+    obj->event = cfg->event;
+    obj->get_time = cfg->get_time;
     obj->deinit = cfg->deinit;
 
     obj->active_low = cfg->active_low;
     obj->irq_cfg = cfg->irq_cfg;
-    obj->debounce_counter_initial_value = cfg->debounce_counter_initial_value;
-    obj->debounce_counter_current_value = obj->debounce_counter_initial_value;
-    obj->autopress_counter_initial_value = cfg->autopress_counter_initial_value;
-    obj->autopress_counter_current_value = cfg->autopress_counter_initial_value;
 
-    /* Set initial state to inactive to detect first press */
-    obj->prev_state = cfg->active_low;
+    obj->debounce_ms = cfg->debounce_ms;
+    obj->long_press_ms = cfg->long_press_ms;
+    obj->repeat_ms = cfg->repeat_ms;
+    obj->double_click_ms = cfg->double_click_ms;
 
-    if (obj->debounce_counter_initial_value == UINT16_MAX)
-        obj->debounce_counter_initial_value--;
-
-    if (obj->autopress_counter_initial_value == UINT16_MAX)
-        obj->autopress_counter_initial_value--;
+    /* Set initial state to inactive to detect first press, first process call samples the pin */
+    obj->edge_pending = true;
+    obj->pressed = false;
+    obj->debouncing = false;
+    obj->long_press_reported = false;
+    obj->click_pending = false;
 
     return obj->init();
 }
@@ -122,24 +136,61 @@ bool button_process(struct button_obj *obj)
     if (!obj)
         return false;
 
+#if BUTTON_USE_IRQ
     if (obj->irq_cfg)
     {
-    #if BUTTON_USE_IRQ
-        return process_irq(obj);
-    #endif
+        /* Nothing to do until pin changes or any deadline is pending */
+        if (!obj->edge_pending && !obj->pressed && !obj->debouncing && !obj->click_pending)
+            return false;
+
+        /* Cleared before sampling, so edge during processing is not lost */
+        obj->edge_pending = false;
+    }
+#endif
+
+    uint16_t now = obj->get_time();
+    bool state = obj->get_state() ^ obj->active_low;
+
+    if (state != obj->pressed)
+    {
+        if (!obj->debouncing)
+        {
+            obj->debouncing = true;
+            obj->debounce_start = now;
+        }
+
+        /* State has to be stable for whole debounce time */
+        if (time_passed(now, obj->debounce_start, obj->debounce_ms))
+        {
+            obj->debouncing = false;
+            obj->pressed = state;
+            handle_edge(obj, now);
+        }
     }
     else
     {
-    #if BUTTON_USE_POLLING
-        return process_poll(obj);
-    #endif
+        /* Bounce - back to debounced state */
+        obj->debouncing = false;
     }
 
-    return false;
+    handle_deadlines(obj, now);
+
+    return obj->pressed;
+}
+
+void button_irq_handler(struct button_obj *obj)
+{
+    if (!obj)
+        return;
+
+    obj->edge_pending = true;
 }
 
 bool button_deinit(struct button_obj *obj)
 {
+    if (!obj || !obj->deinit)
+        return false;
+
     return obj->deinit();
 }
 
@@ -32,42 +32,68 @@ extern "C" {
 
 //------------------------------------------------------------------------------
 
+enum button_event
+{
+    BUTTON_EVENT_PRESS,         /* Debounced transition to active state */
+    BUTTON_EVENT_RELEASE,       /* Debounced transition to inactive state */
+    BUTTON_EVENT_CLICK,         /* Short press not followed by second one within double click time */
+    BUTTON_EVENT_DOUBLE_CLICK,  /* Second short press within double click time */
+    BUTTON_EVENT_LONG_PRESS,    /* Button held for long press time (no click is reported for that press) */
+    BUTTON_EVENT_REPEAT,        /* Button still held after long press, reported every repeat time */
+};
+
+//------------------------------------------------------------------------------
+
 typedef bool (*button_init_cb)(void);
 typedef bool (*button_get_state_cb)(void);
-typedef void (*button_pressed_cb)(void);
+typedef void (*button_event_cb)(enum button_event event);
+typedef uint16_t (*button_get_time_cb)(void);
 typedef bool (*button_deinit_cb)(void);
 
 //------------------------------------------------------------------------------
 
 struct button_cfg
 {
-	button_init_cb init;
-	button_get_state_cb get_state;
-	button_pressed_cb pressed;
-	button_deinit_cb deinit;
-    
+    button_init_cb init;
+    button_get_state_cb get_state;
+    button_event_cb event;
+    button_get_time_cb get_time;    /* Millisecond time base */
+    button_deinit_cb deinit;
+
     bool active_low;
-    bool irq_cfg;
+    bool irq_cfg;                   /* button_irq_handler called on pin change, process is idle until then */
 
-	uint16_t debounce_counter_initial_value;
-	uint16_t autopress_counter_initial_value;
+    uint16_t debounce_ms;
+    uint16_t long_press_ms;         /* 0 disables long press and repeat */
+    uint16_t repeat_ms;             /* 0 disables repeat */
+    uint16_t double_click_ms;       /* 0 disables double click, click is reported on release */
 };
 
 struct button_obj
 {
-	button_init_cb init;
-	button_get_state_cb get_state;
-	button_pressed_cb pressed;
-	button_deinit_cb deinit;
-    
+    button_init_cb init;
+    button_get_state_cb get_state;
+    button_event_cb event;
+    button_get_time_cb get_time;
+    button_deinit_cb deinit;
+
     bool active_low;
     bool irq_cfg;
-    
-    volatile bool prev_state;
-	uint16_t debounce_counter_initial_value;
-	volatile uint16_t debounce_counter_current_value;
-	uint16_t autopress_counter_initial_value;
-	volatile uint16_t autopress_counter_current_value;
+
+    uint16_t debounce_ms;
+    uint16_t long_press_ms;
+    uint16_t repeat_ms;
+    uint16_t double_click_ms;
+
+    volatile bool edge_pending;
+    bool pressed;                   /* Debounced state */
+    bool debouncing;
+    bool long_press_reported;
+    bool click_pending;
+    uint16_t debounce_start;
+    uint16_t press_time;
+    uint16_t repeat_time;
+    uint16_t release_time;
 };
 
 //------------------------------------------------------------------------------
@@ -78,12 +104,18 @@ struct button_obj
 /// @return propagates button_init_cb callback return value if cfg structure is valid
 bool button_init(struct button_obj *obj, struct button_cfg *cfg);
 
-/// @brief Updates button state and call callback when it's pressed
-/// @note Should be called periodically or inside ISR if configured
+/// @brief Debounces button state against time deadlines and reports events @ref enum button_event
+/// @note Should be called periodically from main loop, in IRQ configuration it returns immediately 
+///       until button_irq_handler is called and while no press, debounce or double click deadline is pending
 /// @param obj button object structure pointer
-/// @return current button state
+/// @return current debounced button state (true if pressed)
 bool button_process(struct button_obj *obj);
 
+/// @brief Notifies button driver about pin change
+/// @note Should be called from pin change interrupt in IRQ configuration
+/// @param obj button object structure pointer
+void button_irq_handler(struct button_obj *obj);
+
 /// @brief Deinitializes button low level driver and resets context
 /// @param obj button object structure pointer
 /// @return propagates button_deinit_cb callback return value if cfg structure is valid
@@ -20,17 +20,115 @@
 
 #include "buzzer.h"
 
+#include <string.h>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#else
+#define memcpy_P memcpy
+#define ATOMIC_BLOCK(type)
+#endif
+
+//------------------------------------------------------------------------------
+
+#ifndef BUZZER_USE_SEQUENCER
+#define BUZZER_USE_SEQUENCER 0
+#endif
+
+//------------------------------------------------------------------------------
+
+static void get_note(struct buzzer_obj *obj, uint16_t idx, struct buzzer_note *note)
+{
+	if (obj->current_pattern_in_flash)
+		memcpy_P(note, &obj->current_pattern[idx], sizeof(*note));
+	else
+		*note = obj->current_pattern[idx];
+}
+
+#if BUZZER_USE_SEQUENCER
+static bool sequencer_enabled(struct buzzer_obj *obj)
+{
+	return obj->steps != NULL;
+}
+
+static void sequencer_load(struct buzzer_obj *obj)
+{
+	/* ISR does not touch the steps until sequencer is started again, atomic block is also a compiler barrier,
+	   so step writes below cannot be moved before the flag */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		obj->sequencer_running = false;
+	}
+
+	if (!obj->current_pattern)
+		return;
+
+	uint16_t count = obj->current_pattern_size / sizeof(struct buzzer_note);
+
+	if (count > obj->steps_max)
+		count = obj->steps_max;
+
+	/* Divisions and flash reads done once per pattern instead of on every process call */
+	for (uint8_t i = 0; i < count; i++)
+	{
+		struct buzzer_note note;
+
+		get_note(obj, i, &note);
+
+		uint32_t ticks = note.note / obj->current_pattern_bpm;
+
+		obj->steps[i].reg = obj->tone_to_reg(note.tone);
+		obj->steps[i].ticks = ticks > UINT16_MAX ? UINT16_MAX : (ticks ? ticks : 1);
+	}
+
+	obj->steps_count = count;
+
+	if (!count)
+		return;
+
+	/* Steps table is completely written before tick ISR may see the running flag */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		obj->sequencer_step = 0;
+		obj->sequencer_ticks_left = obj->steps[0].ticks;
+		obj->set_reg(obj->steps[0].reg);
+
+		obj->sequencer_running = true;
+	}
+}
+#endif
+
 //------------------------------------------------------------------------------
 
 bool buzzer_init(struct buzzer_obj *obj, struct buzzer_cfg *cfg)
 {
-	if (!cfg || !cfg->init || !cfg->play || !cfg->stop)
+	if (!cfg || !cfg->init || !cfg->stop)
 		return false;
 
 	obj->init = cfg->init;
 	obj->play = cfg->play;
 	obj->stop = cfg->stop;
 	obj->deinit = cfg->deinit;
+	obj->tone_to_reg = cfg->tone_to_reg;
+	obj->set_reg = cfg->set_reg;
+
+	obj->current_pattern = NULL;
+	obj->steps = NULL;
+	obj->steps_max = 0;
+	obj->steps_count = 0;
+	obj->sequencer_running = false;
+
+#if BUZZER_USE_SEQUENCER
+	if (cfg->tone_to_reg && cfg->set_reg && cfg->steps && cfg->steps_max)
+	{
+		obj->steps = cfg->steps;
+		obj->steps_max = cfg->steps_max;
+	}
+#endif
+
+	if (!obj->steps && !obj->play)
+		return false;
 
 	return obj->init();
 }
@@ -45,6 +143,7 @@ void buzzer_play_pattern(struct buzzer_obj *obj, const struct buzzer_note patter
 
 void buzzer_stop_pattern(struct buzzer_obj *obj)
 {
+	obj->sequencer_running = false;
 	obj->stop();
 }
 
@@ -53,21 +152,66 @@ void buzzer_set_pattern(struct buzzer_obj *obj, const struct buzzer_note pattern
 	obj->current_pattern = pattern;
 	obj->current_pattern_size = size;
 	obj->current_pattern_bpm = bpm;
+	obj->current_pattern_in_flash = false;
+	obj->current_step = 0;
+
+#if BUZZER_USE_SEQUENCER
+	if (sequencer_enabled(obj))
+		sequencer_load(obj);
+#endif
+}
+
+void buzzer_set_pattern_P(struct buzzer_obj *obj, const struct buzzer_note pattern[], uint16_t size, uint16_t bpm)
+{
+	obj->current_pattern = pattern;
+	obj->current_pattern_size = size;
+	obj->current_pattern_bpm = bpm;
+	obj->current_pattern_in_flash = true;
 	obj->current_step = 0;
+
+#if BUZZER_USE_SEQUENCER
+	if (sequencer_enabled(obj))
+		sequencer_load(obj);
+#endif
 }
 
 void buzzer_process(struct buzzer_obj *obj)
 {
-	if (!obj || !obj->current_pattern)
+	if (!obj || !obj->current_pattern || obj->steps)
 		return;
 
-	if (obj->play(obj->current_pattern[obj->current_step].tone, obj->current_pattern[obj->current_step].note / obj->current_pattern_bpm))
+	struct buzzer_note note;
+
+	get_note(obj, obj->current_step, &note);
+
+	if (obj->play(note.tone, note.note / obj->current_pattern_bpm))
 		return; // Note is still played
 
 	/* Callback returned false - note is already played, go to next note */
 	obj->current_step == (obj->current_pattern_size / sizeof(struct buzzer_note)) - 1 ? obj->current_step = 0 : obj->current_step++;
 }
 
+void buzzer_tick(struct buzzer_obj *obj)
+{
+#if BUZZER_USE_SEQUENCER
+	if (!obj->sequencer_running)
+		return;
+
+	if (--obj->sequencer_ticks_left)
+		return;
+
+	/* Note boundary - next step, pattern is looped */
+	if (++obj->sequencer_step >= obj->steps_count)
+		obj->sequencer_step = 0;
+
+	struct buzzer_step *step = &obj->steps[obj->sequencer_step];
+
+	obj->sequencer_ticks_left = step->ticks;
+	obj->set_reg(step->reg);
+#endif
+	(void)obj;
+}
+
 bool buzzer_deinit(struct buzzer_obj *obj)
 {
 	return obj->deinit();
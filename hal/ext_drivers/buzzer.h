@@ -132,34 +132,61 @@ extern "C" {
 
 #define BUZZER_TONE_STOP 		0
 
+#define BUZZER_STEP_REG_STOP 	0
+
 //------------------------------------------------------------------------------
 
 typedef bool (*buzzer_init_cb)(void);
 typedef bool (*buzzer_play_cb)(uint16_t tone, uint16_t time_ms);
 typedef void (*buzzer_stop_cb)(void);
 typedef bool (*buzzer_deinit_cb)(void);
+typedef uint8_t (*buzzer_tone_to_reg_cb)(uint16_t tone);
+typedef void (*buzzer_set_reg_cb)(uint8_t reg);
 
 //------------------------------------------------------------------------------
 
+/* Sequencer step precomputed by buzzer_set_pattern - timer register value and duration in buzzer_tick periods */
+struct buzzer_step
+{
+	uint8_t reg;
+	uint16_t ticks;
+};
+
 struct buzzer_obj
 {
 	buzzer_init_cb init;
 	buzzer_play_cb play;
 	buzzer_stop_cb stop;
 	buzzer_deinit_cb deinit;
+	buzzer_tone_to_reg_cb tone_to_reg;
+	buzzer_set_reg_cb set_reg;
 
 	const struct buzzer_note *current_pattern;
 	uint16_t current_pattern_size;
 	uint16_t current_pattern_bpm;
 	uint16_t current_step;
+	bool current_pattern_in_flash;
+
+	struct buzzer_step *steps;
+	uint8_t steps_max;
+	uint8_t steps_count;
+	volatile bool sequencer_running;
+	uint8_t sequencer_step;
+	uint16_t sequencer_ticks_left;
 };
 
 struct buzzer_cfg
 {
 	buzzer_init_cb init;
-	buzzer_play_cb play;
+	buzzer_play_cb play;					/* Not used in sequencer mode */
 	buzzer_stop_cb stop;
 	buzzer_deinit_cb deinit;
+
+	/* Sequencer mode (BUZZER_USE_SEQUENCER) - used when all fields are set */
+	buzzer_tone_to_reg_cb tone_to_reg;		/* Tone to timer register value, BUZZER_STEP_REG_STOP for silence */
+	buzzer_set_reg_cb set_reg;				/* Called from buzzer_tick (ISR) on note boundary */
+	struct buzzer_step *steps;				/* Step buffer, longer patterns are truncated */
+	uint8_t steps_max;
 };
 
 struct buzzer_note
@@ -194,10 +221,23 @@ void buzzer_stop_pattern(struct buzzer_obj *obj);
 /// @param bpm selected autio pattern BPM
 void buzzer_set_pattern(struct buzzer_obj *obj, const struct buzzer_note pattern[], uint16_t size, uint16_t bpm);
 
+/// @brief Sets current pattern placed in program memory (PROGMEM) for non-blocking play mode (@ref buzzer_process())
+/// @param obj buzzer object structure pointer
+/// @param pattern selected autio pattern array in program memory @ref struct note
+/// @param size selected autio pattern array size in bytes
+/// @param bpm selected autio pattern BPM
+void buzzer_set_pattern_P(struct buzzer_obj *obj, const struct buzzer_note pattern[], uint16_t size, uint16_t bpm);
+
 /// @brief Processes current audio pattern
+/// @note Does nothing in sequencer mode - pattern is advanced by @ref buzzer_tick
 /// @param obj buzzer object structure pointer
 void buzzer_process(struct buzzer_obj *obj);
 
+/// @brief Advances current pattern in sequencer mode
+/// @note Should be called from timer interrupt with 1 ms period (note durations are given in ms)
+/// @param obj buzzer object structure pointer
+void buzzer_tick(struct buzzer_obj *obj);
+
 /// @brief Deinitializes buzzer low level driver and resets context
 /// @param obj buzzer object structure pointer
 /// @return propagates buzzer_deinit_ll callback return value if cfg structure is valid
@@ -65,6 +65,12 @@ bool ds1307_init(struct ds1307_obj *obj, struct ds1307_cfg *cfg)
     obj->serial_send = cfg->serial_send;
     obj->serial_receive = cfg->serial_receive;
 
+    if (obj->io_init && !obj->io_init())
+        return false;
+
+    if (cfg->warm_start)
+        return true;
+
     /* Set Rate and SQW */
     uint8_t msg[] = {DS1307_REG_ADDR_CONTROL, (cfg->rs & 0x03) | (cfg->sqw_en << 4)};
 
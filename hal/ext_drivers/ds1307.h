@@ -70,6 +70,7 @@ struct ds1307_cfg
 
     bool sqw_en;
     enum ds1307_rate_select rs;
+    bool warm_start; /* Control register is battery backed - skip its write after MCU-only reset */
 };
 
 struct ds1307_obj
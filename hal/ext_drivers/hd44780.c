@@ -25,6 +25,13 @@
 #include <stdio.h>
 #include <unistd.h>
 
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#endif
+
 //------------------------------------------------------------------------------
 
 enum hd44780_mode
@@ -121,15 +128,18 @@ bool hd44780_init(struct hd44780_obj *obj, struct hd44780_cfg *cfg)
     for (uint8_t i = 0; i < 7; i++)
         obj->set_pin_state(LCD_RS + i, false);
     
-    /* Initialize LCD */
-    obj->delay_us(50000); // Done twice to reduce delay parameter size to uint16_t
-    obj->delay_us(50000);
+    /* Initialize LCD - power-up delay is not needed if controller was not powered down */
+    if (!cfg->warm_start)
+    {
+        obj->delay_us(50000); // Done twice to reduce delay parameter size to uint16_t
+        obj->delay_us(50000);
+    }
 
     /* LCD is initialized by default with 8-bit data bus so there is a need to double each nibble */
     /* Set 8-bit data bus command at least 3 times - specific for some displays */
     /* Then 4-bit but still in 8 bit mode - lower nibble has to be 4 bit set command */
 
-    static const uint8_t initialization_bytes[] = 
+    static const uint8_t initialization_bytes[] PROGMEM = 
     {
         HD44780_CMD_FUNCTION_SET_DL_8_BITS | (HD44780_CMD_FUNCTION_SET_DL_8_BITS >> 4),
         HD44780_CMD_FUNCTION_SET_DL_8_BITS | (HD44780_CMD_FUNCTION_SET_DL_4_BITS >> 4),
@@ -142,10 +152,10 @@ bool hd44780_init(struct hd44780_obj *obj, struct hd44780_cfg *cfg)
     };
 
     for (uint8_t i = 0; i < sizeof(initialization_bytes); i++)
-        send_byte(obj, initialization_bytes[i], MODE_COMMAND);
+        send_byte(obj, pgm_read_byte(&initialization_bytes[i]), MODE_COMMAND);
 
-    /* Load user defined characters to CGRAM */
-    if (cfg->user_defined_char_tab)
+    /* Load user defined characters to CGRAM (kept by powered controller) */
+    if (cfg->user_defined_char_tab && !cfg->warm_start)
     {
         for (uint8_t char_idx = 0; char_idx < cfg->user_defined_char_tab_len; char_idx++)
         {
@@ -154,7 +164,7 @@ bool hd44780_init(struct hd44780_obj *obj, struct hd44780_cfg *cfg)
 
             for (uint8_t byte_idx = 0; byte_idx < 8; byte_idx++)
             {
-                send_byte(obj, cfg->user_defined_char_tab[char_idx][byte_idx], MODE_DATA);
+                send_byte(obj, pgm_read_byte(&cfg->user_defined_char_tab[char_idx][byte_idx]), MODE_DATA);
             }
         }
 
@@ -172,6 +182,15 @@ void hd44780_print(struct hd44780_obj *obj, const char* str)
         send_byte(obj, *str++, MODE_DATA);
 }
 
+void hd44780_print_P(struct hd44780_obj *obj, const char* str)
+{
+    /* Write null terminated string from program memory */
+    char ch;
+
+    while ((ch = pgm_read_byte(str++)))
+        send_byte(obj, ch, MODE_DATA);
+}
+
 void hd44780_putc(struct hd44780_obj *obj, const char ch)
 {
     send_byte(obj, ch, MODE_DATA);
@@ -61,6 +61,7 @@ struct hd44780_cfg
 
     const uint8_t (*user_defined_char_tab)[8];
     uint8_t user_defined_char_tab_len;
+    bool warm_start; /* Controller stayed powered (MCU reset only) - skip power-up delay and CGRAM reload */
 };
 
 struct hd44780_obj 
@@ -75,7 +76,8 @@ struct hd44780_obj
 
 /// @brief Initializes HD44780, IO and register callbacks
 /// @note This driver does not read BUSY flag - RW pin can be connected to GND
-/// @note User defined chars have to be placed in 2-dimensional array [ch_idx][byte_idx]
+/// @note User defined chars have to be placed in 2-dimensional array [ch_idx][byte_idx] in program memory (PROGMEM)
+/// @note Warm start resynchronizes 4-bit interface (also from the middle of interrupted transfer) in a few ms
 /// @param obj given LCD object @ref struct hd44780_obj
 /// @param cfg given LCD configuration @ref struct hd4470_cfg
 /// @return true if initialized correctly, otherwise false
@@ -86,6 +88,11 @@ bool hd44780_init(struct hd44780_obj *obj, struct hd44780_cfg *cfg);
 /// @param str null terminated string
 void hd44780_print(struct hd44780_obj *obj, const char* str);
 
+/// @brief Prints given null-terminated string placed in program memory (PROGMEM) after last string's end
+/// @param obj given LCD object @ref struct hd44780_obj
+/// @param str null terminated string in program memory
+void hd44780_print_P(struct hd44780_obj *obj, const char* str);
+
 /// @brief Prints given char after last string's end
 /// @param obj given LCD object @ref struct hd44780_obj
 /// @param ch selected characer code
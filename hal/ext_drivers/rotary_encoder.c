@@ -22,6 +22,13 @@
 
 #include <stddef.h>
 
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#endif
+
 //------------------------------------------------------------------------------
 
 #ifndef ROTARY_ENCODER_USE_IRQ
@@ -106,6 +113,60 @@ static enum rotary_encoder_direction process_irq(struct rotary_encoder_obj *obj)
 
     return dir;
 }
+
+static uint8_t get_acceleration(struct rotary_encoder_obj *obj, enum rotary_encoder_direction dir)
+{
+    if (!obj->get_time_cb || obj->accel_max < 2)
+        return 1;
+
+    uint16_t now = obj->get_time_cb();
+    uint16_t interval = now - obj->last_step_time;
+
+    obj->last_step_time = now;
+
+    /* Direction change always starts from single step */
+    if (dir != obj->last_dir)
+    {
+        obj->last_dir = dir;
+        return 1;
+    }
+
+    if (interval >= obj->accel_threshold_ms)
+        return 1;
+
+    /* Linear from 1 (at threshold) to accel_max (at 0 ms) */
+    return 1 + (uint32_t)(obj->accel_max - 1) * (obj->accel_threshold_ms - interval) / obj->accel_threshold_ms;
+}
+
+static enum rotary_encoder_direction process_irq_ab(struct rotary_encoder_obj *obj)
+{
+    /* Index is previous and current AB state - 0 for no change and invalid (both pins changed) transitions */
+    static const int8_t transition_tab[16] PROGMEM =
+    {
+         0, -1,  1,  0,
+         1,  0,  0, -1,
+        -1,  0,  0,  1,
+         0,  1, -1,  0,
+    };
+
+    uint8_t current_pos = obj->get_a_cb() << 1 | obj->get_b_cb();
+
+    obj->sub_step_cnt += (int8_t)pgm_read_byte(&transition_tab[obj->prev_pos << 2 | current_pos]);
+    obj->prev_pos = current_pos;
+
+    /* Contact bounce produces opposite transitions which cancel each other - no debounce needed */
+    if (obj->sub_step_cnt > -(int8_t)obj->sub_steps_count && obj->sub_step_cnt < (int8_t)obj->sub_steps_count)
+        return ROTARY_ENCODER_DIR_NONE;
+
+    enum rotary_encoder_direction dir = (obj->sub_step_cnt > 0) ? ROTARY_ENCODER_DIR_RIGHT : ROTARY_ENCODER_DIR_LEFT;
+
+    obj->sub_step_cnt = 0;
+    obj->step_cnt += dir * get_acceleration(obj, dir);
+
+    obj->rotation_cb(dir, obj->step_cnt);
+
+    return dir;
+}
 #endif
 
 //------------------------------------------------------------------------------
@@ -124,19 +185,25 @@ bool rotary_encoder_init(struct rotary_encoder_obj *obj, struct rotary_encoder_c
     obj->irq_cfg = cfg->irq_cfg;
     obj->sub_steps_count = cfg->sub_steps_count;
 
+    obj->get_time_cb = cfg->get_time_cb;
+    obj->accel_threshold_ms = cfg->accel_threshold_ms;
+    obj->accel_max = cfg->accel_max;
+    obj->last_dir = ROTARY_ENCODER_DIR_NONE;
+
     obj->debounce_counter_initial_value = cfg->debounce_counter_initial_value;
     obj->debounce_counter_current_value = obj->debounce_counter_initial_value;
 
     if (obj->debounce_counter_initial_value == UINT16_MAX)
         obj->debounce_counter_initial_value--;
 
-    /* Set initial positon (for polling mode) */
+    /* Set initial positon (for polling mode - gray code converted to binary, for AB mode - raw AB state) */
     bool a = obj->get_a_cb();
     bool b = obj->get_b_cb();
 
-    obj->prev_pos = a << 1 | (a ^ b);
+    obj->prev_pos = (obj->irq_cfg == ROTARY_ENCODER_IRQ_CONFIG_AB) ? (a << 1 | b) : (a << 1 | (a ^ b));
 
     obj->step_cnt = 0;
+    obj->sub_step_cnt = 0;
 
     return obj->init_cb();
 }
@@ -155,6 +222,9 @@ enum rotary_encoder_direction rotary_encoder_process(struct rotary_encoder_obj *
     else
     {
     #if ROTARY_ENCODER_USE_IRQ
+        if (obj->irq_cfg == ROTARY_ENCODER_IRQ_CONFIG_AB)
+            return process_irq_ab(obj);
+
         return process_irq(obj);
     #endif
     }
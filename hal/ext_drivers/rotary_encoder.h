@@ -44,6 +44,7 @@ enum rotary_encoder_irq_config
     ROTARY_ENCODER_IRQ_CONFIG_A = 0, 
     ROTARY_ENCODER_IRQ_CONFIG_B,
     ROTARY_ENCODER_IRQ_CONFIG_NONE,
+    ROTARY_ENCODER_IRQ_CONFIG_AB,   /* Both edges of both channels, quadrature transition table */
 };
 
 //------------------------------------------------------------------------------
@@ -53,6 +54,7 @@ typedef bool (*rotary_encoder_get_b_cb)(void);
 typedef void (*rotary_encoder_rotation_cb)(enum rotary_encoder_direction dir, int8_t step_cnt);
 typedef bool (*rotary_encoder_init_cb)(void);
 typedef bool (*rotary_encoder_deinit_cb)(void);
+typedef uint16_t (*rotary_encoder_get_time_cb)(void);
 
 //------------------------------------------------------------------------------
 
@@ -67,6 +69,11 @@ struct rotary_encoder_cfg
     enum rotary_encoder_irq_config irq_cfg;
     uint8_t sub_steps_count;
     volatile uint16_t debounce_counter_initial_value;
+
+    /* Velocity acceleration (optional, valid only for ROTARY_ENCODER_IRQ_CONFIG_AB) */
+    rotary_encoder_get_time_cb get_time_cb; /* Millisecond tickstamp, NULL disables acceleration */
+    uint16_t accel_threshold_ms;            /* Detent interval below which acceleration starts */
+    uint8_t accel_max;                      /* Steps per detent at the highest speed */
 };
 
 struct rotary_encoder_obj
@@ -82,6 +89,13 @@ struct rotary_encoder_obj
 
     volatile uint8_t prev_pos;
     volatile int8_t step_cnt;
+    volatile int8_t sub_step_cnt;
+
+    rotary_encoder_get_time_cb get_time_cb;
+    uint16_t accel_threshold_ms;
+    uint8_t accel_max;
+    uint16_t last_step_time;
+    enum rotary_encoder_direction last_dir;
 
     volatile uint16_t debounce_counter_initial_value;
     volatile uint16_t debounce_counter_current_value;
@@ -99,6 +113,8 @@ bool rotary_encoder_init(struct rotary_encoder_obj *obj, struct rotary_encoder_c
 
 /// @brief Updates rotary encoder state and call callbacks when full transition occured
 /// @note It has to be called periodically without long delays or call inside ISR triggered by rising or falling edge of selected pin (A / B)
+/// @note For ROTARY_ENCODER_IRQ_CONFIG_AB it has to be called inside ISR triggered by any edge of both pins,
+///       with acceleration step_cnt passed to rotation callback can change by more than 1
 /// @param obj - rotary encoder object structure pointer
 /// @return last full transition direction according to @ref enum rotary_encoder_direction
 enum rotary_encoder_direction rotary_encoder_process(struct rotary_encoder_obj *obj);
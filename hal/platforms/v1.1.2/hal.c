@@ -29,6 +29,8 @@
 #include <avr/power.h>
 #include <avr/eeprom.h> 
 
+#include <util/atomic.h>
+
 #include <button.h>
 #include <buzzer.h> 
 #include <rotary_encoder.h>
@@ -37,10 +39,16 @@
 #include <mas6181b.h>
 
 #include <gpio.h>
+#include <gpio_static.h>
 #include <exti.h>  
 #include <timer.h>
 #include <twi.h>
 #include <usart.h>
+#include <profiler.h>
+
+#include <stack_monitor.h>
+#include <reset_cause.h>
+#include <fault_journal.h>
 
 //------------------------------------------------------------------------------
 
@@ -71,10 +79,37 @@ ISR(BADISR_vect)
 /* Application layer callbacks TODO: Consider callback registration */
 
 __attribute__((weak)) void hal_exti_sqw_cb(void); 
-__attribute__((weak)) void hal_button_pressed_cb(void); 
-__attribute__((weak)) void hal_encoder_rotation_cb(int8_t dir); 
+__attribute__((weak)) void hal_button_event_cb(enum button_event event); 
+__attribute__((weak)) void hal_encoder_rotation_cb(int8_t steps); /* Sign is direction, magnitude includes acceleration */
 __attribute__((weak)) void hal_dcf_cb(uint16_t ms, bool triggred_on_bit); 
-__attribute__((weak)) const uint8_t hal_user_defined_char_tab[6][8];
+__attribute__((weak)) void hal_serial_rx_cb(uint8_t byte, bool error); 
+__attribute__((weak)) const uint8_t hal_user_defined_char_tab[6][8] PROGMEM;
+
+/* Warm state - kept in .noinit over watchdog / brown-out reset, valid with magic and check byte only */
+
+#define HAL_WARM_STATE_MAGIC 0xB007
+
+struct hal_warm_state
+{
+    uint16_t magic;
+    uint8_t flags;
+    uint8_t check;  /* Inverted flags */
+};
+
+static struct hal_warm_state warm_state __attribute__((section(".noinit")));
+
+static bool warm_boot;
+
+/* EEPROM layout - single alarm of previous versions and timezone at 0x00, fault journal behind them, alarms at the end */
+
+#define HAL_EEPROM_LEGACY_ALARM_ADDR 0x00
+#define HAL_EEPROM_LEGACY_ALARM_SIZE 3
+#define HAL_EEPROM_TIMEZONE_ADDR (HAL_EEPROM_LEGACY_ALARM_ADDR + HAL_EEPROM_LEGACY_ALARM_SIZE)
+#define HAL_EEPROM_ALARMS_ADDR 0x60
+
+_Static_assert(FAULT_JOURNAL_EEPROM_ADDR >= HAL_EEPROM_TIMEZONE_ADDR + sizeof(int8_t), "Fault journal overlaps settings");
+_Static_assert(HAL_EEPROM_ALARMS_ADDR >= FAULT_JOURNAL_EEPROM_ADDR + FAULT_JOURNAL_EEPROM_SIZE, "Alarms overlap fault journal");
+_Static_assert(HAL_EEPROM_ALARMS_ADDR + HAL_ALARMS_COUNT * sizeof(struct hal_alarm) <= E2END + 1, "Alarms do not fit in EEPROM");
 
 /* Pin assignement */
 
@@ -84,6 +119,12 @@ __attribute__((weak)) const uint8_t hal_user_defined_char_tab[6][8];
 #define HAL_BUZZER_PIN GPIO_PIN_3
 #define HAL_BUZZER_PORT GPIO_PORT_D
 
+#define HAL_BUZZER_SEQUENCER_STEPS 12
+
+/* Baud rates selectable at runtime, USART_FIXED_BAUDRATE is used after reset (19200 and 38400 are not reachable at 1 MHz) */
+#define HAL_SERIAL_BAUDRATE_MEDIUM 31250UL
+#define HAL_SERIAL_BAUDRATE_HIGH 62500UL
+
 #define HAL_LCD_RS_PIN GPIO_PIN_3
 #define HAL_LCD_RS_PORT GPIO_PORT_C
 
@@ -104,14 +145,24 @@ __attribute__((weak)) const uint8_t hal_user_defined_char_tab[6][8];
 
 #define HAL_BUTTON_PIN GPIO_PIN_2
 #define HAL_BUTTON_PORT GPIO_PORT_B
+#define HAL_BUTTON_EXTI_ID EXTI_ID_PCINT2
+#define HAL_BUTTON_EXTI_TRIGGER EXTI_TRIGGER_CHANGE
+
+#define HAL_BUTTON_DEBOUNCE_MS 20
+#define HAL_BUTTON_LONG_PRESS_MS 1000
+#define HAL_BUTTON_REPEAT_MS 250
+#define HAL_BUTTON_DOUBLE_CLICK_MS 300
 
 #define HAL_ENCODER_A_PIN GPIO_PIN_2
 #define HAL_ENCODER_A_PORT GPIO_PORT_D  
 #define HAL_ENCODER_B_PIN GPIO_PIN_3
 #define HAL_ENCODER_B_PORT GPIO_PORT_D
 
-#define HAL_ENCODER_EXTI_ID EXTI_ID_INT0
-#define HAL_ENCODER_EXTI_TRIGGER EXTI_TRIGGER_FALLING_EDGE
+#define HAL_ENCODER_A_EXTI_ID EXTI_ID_INT0
+#define HAL_ENCODER_B_EXTI_ID EXTI_ID_INT1
+#define HAL_ENCODER_EXTI_TRIGGER EXTI_TRIGGER_CHANGE
+#define HAL_ENCODER_ACCEL_THRESHOLD_MS 100
+#define HAL_ENCODER_ACCEL_MAX 10
 
 #define HAL_DS1307_COMM_RETRY_COUNT 5
 
@@ -157,11 +208,52 @@ static struct timer_cfg timer2_cfg =
 
 static struct timer_obj timer2_obj;
 
+static struct buzzer_obj buzzer1_obj;
+
+#if BUZZER_USE_SEQUENCER
+static struct buzzer_step buzzer1_steps[HAL_BUZZER_SEQUENCER_STEPS];
+#endif
+
 static bool buzzer1_init_cb(void)
 {
+#if BUZZER_USE_SEQUENCER
+    /* Timer2 configured once, sequencer only reloads OCR2A and gates the clock */
+    timer_init(&timer2_obj, &timer2_cfg);
+#endif
     return true;
 }
 
+#if BUZZER_USE_SEQUENCER
+static uint8_t buzzer1_tone_to_reg_cb(uint16_t tone)
+{
+    if (tone == BUZZER_TONE_STOP)
+        return BUZZER_STEP_REG_STOP;
+
+    uint32_t reg = (F_CPU / (2UL * 8 * tone)) - 1;
+
+    /* Tones below ~245 Hz do not fit 8-bit Timer2 with prescaler 8 */
+    return reg > UINT8_MAX ? UINT8_MAX : (reg == BUZZER_STEP_REG_STOP ? 1 : reg);
+}
+
+static void buzzer1_set_reg_cb(uint8_t reg)
+{
+    if (reg == BUZZER_STEP_REG_STOP)
+    {
+        timer_start(&timer2_obj, false);
+        return;
+    }
+
+    OCR2A = reg;
+    TCNT2 = 0;
+    timer_start(&timer2_obj, true);
+}
+
+static void system_tick_cb(void)
+{
+    buzzer_tick(&buzzer1_obj);
+}
+#endif
+
 static bool buzzer1_play_cb(uint16_t tone, uint16_t time_ms)
 {
     static uint32_t start_tickstamp = 0;
@@ -202,31 +294,42 @@ static struct buzzer_cfg buzzer1_cfg =
 	.play = buzzer1_play_cb,
 	.stop = buzzer1_stop_cb,
 	.deinit = NULL,
+#if BUZZER_USE_SEQUENCER
+	.tone_to_reg = buzzer1_tone_to_reg_cb,
+	.set_reg = buzzer1_set_reg_cb,
+	.steps = buzzer1_steps,
+	.steps_max = HAL_BUZZER_SEQUENCER_STEPS,
+#endif
 };
 
-static struct buzzer_obj buzzer1_obj;
-
 /* LCD */
 
-struct gpio_tuple
-{
-    enum gpio_port port;
-    enum gpio_pin pin;
-};
-
-static const struct gpio_tuple lcd_pins[] =
-{
-    [LCD_RS] = {HAL_LCD_RS_PORT, HAL_LCD_RS_PIN},
-    [LCD_E]  = {HAL_LCD_E_PORT, HAL_LCD_E_PIN},
-    [LCD_D4] = {HAL_LCD_D4_PORT, HAL_LCD_D4_PIN},
-    [LCD_D5] = {HAL_LCD_D5_PORT, HAL_LCD_D5_PIN},
-    [LCD_D6] = {HAL_LCD_D6_PORT, HAL_LCD_D6_PIN},
-    [LCD_D7] = {HAL_LCD_D7_PORT, HAL_LCD_D7_PIN},
-};
-
 static void lcd_set_pin_cb(uint8_t pin, bool state)
 {
-    gpio_set(lcd_pins[pin].port, lcd_pins[pin].pin, state);
+    /* Constant port / pin in every case - each access is single sbi / cbi */
+    switch (pin)
+    {
+    case LCD_RS:
+        gpio_static_set(HAL_LCD_RS_PORT, HAL_LCD_RS_PIN, state);
+        break;
+    case LCD_E:
+        gpio_static_set(HAL_LCD_E_PORT, HAL_LCD_E_PIN, state);
+        break;
+    case LCD_D4:
+        gpio_static_set(HAL_LCD_D4_PORT, HAL_LCD_D4_PIN, state);
+        break;
+    case LCD_D5:
+        gpio_static_set(HAL_LCD_D5_PORT, HAL_LCD_D5_PIN, state);
+        break;
+    case LCD_D6:
+        gpio_static_set(HAL_LCD_D6_PORT, HAL_LCD_D6_PIN, state);
+        break;
+    case LCD_D7:
+        gpio_static_set(HAL_LCD_D7_PORT, HAL_LCD_D7_PIN, state);
+        break;
+    default:
+        break;
+    }
 }
 
 static void lcd_delay_cb(uint16_t us) 
@@ -237,10 +340,12 @@ static void lcd_delay_cb(uint16_t us)
 
 static void lcd_pin_init_cb(void)
 {
-    for (uint8_t i = 0; i < sizeof(lcd_pins) / sizeof(lcd_pins[0]); i++)
-    {
-        gpio_init(lcd_pins[i].port, lcd_pins[i].pin, true, false);
-    }
+    gpio_static_init(HAL_LCD_RS_PORT, HAL_LCD_RS_PIN, true, false);
+    gpio_static_init(HAL_LCD_E_PORT, HAL_LCD_E_PIN, true, false);
+    gpio_static_init(HAL_LCD_D4_PORT, HAL_LCD_D4_PIN, true, false);
+    gpio_static_init(HAL_LCD_D5_PORT, HAL_LCD_D5_PIN, true, false);
+    gpio_static_init(HAL_LCD_D6_PORT, HAL_LCD_D6_PIN, true, false);
+    gpio_static_init(HAL_LCD_D7_PORT, HAL_LCD_D7_PIN, true, false);
 }
 
 static struct hd44780_cfg lcd_cfg = 
@@ -259,26 +364,31 @@ static struct hd44780_obj lcd_obj;
 
 static bool button1_init_cb(void)
 {
-    return gpio_init(HAL_BUTTON_PORT, HAL_BUTTON_PIN, false, false);
+    gpio_static_init(HAL_BUTTON_PORT, HAL_BUTTON_PIN, false, false);
+
+    return true;
 }
 
 static bool button1_get_state_cb(void)
 {
-    return gpio_get(HAL_BUTTON_PORT, HAL_BUTTON_PIN);
+    return gpio_static_get(HAL_BUTTON_PORT, HAL_BUTTON_PIN);
 }
 
 static struct button_cfg button1_cfg = 
 {
-	.init = button1_init_cb,
-	.get_state = button1_get_state_cb,
-	.pressed = hal_button_pressed_cb,
-	.deinit = NULL,
-    
+    .init = button1_init_cb,
+    .get_state = button1_get_state_cb,
+    .event = hal_button_event_cb,
+    .get_time = system_timer_get,
+    .deinit = NULL,
+
     .active_low = true,
-    .irq_cfg = false,
+    .irq_cfg = true,
 
-	.debounce_counter_initial_value = 255,
-	.autopress_counter_initial_value = 0,
+    .debounce_ms = HAL_BUTTON_DEBOUNCE_MS,
+    .long_press_ms = HAL_BUTTON_LONG_PRESS_MS,
+    .repeat_ms = HAL_BUTTON_REPEAT_MS,
+    .double_click_ms = HAL_BUTTON_DOUBLE_CLICK_MS,
 };
 
 static struct button_obj button1_obj;
@@ -287,26 +397,41 @@ static struct button_obj button1_obj;
 
 static bool encoder1_get_a_cb(void)
 {
-    return gpio_get(HAL_ENCODER_A_PORT, HAL_ENCODER_A_PIN);
+    return gpio_static_get(HAL_ENCODER_A_PORT, HAL_ENCODER_A_PIN);
 };
 
 static bool encoder1_get_b_cb(void)
 {
-    return gpio_get(HAL_ENCODER_B_PORT, HAL_ENCODER_B_PIN);
+    return gpio_static_get(HAL_ENCODER_B_PORT, HAL_ENCODER_B_PIN);
 }
 
 static bool encoder1_init_cb(void)
 {
-    gpio_init(HAL_ENCODER_A_PORT, HAL_ENCODER_A_PIN, false, false);
-    gpio_init(HAL_ENCODER_B_PORT, HAL_ENCODER_B_PIN, false, false);
+    gpio_static_init(HAL_ENCODER_A_PORT, HAL_ENCODER_A_PIN, false, false);
+    gpio_static_init(HAL_ENCODER_B_PORT, HAL_ENCODER_B_PIN, false, false);
 
     return true;
 }
 
+static volatile int8_t encoder1_pending_steps;
+
 static void encoder1_rotation_cb(enum rotary_encoder_direction dir, int8_t step_cnt)
 {
-    (void)step_cnt;
-    hal_encoder_rotation_cb(dir);
+    static int8_t last_step_cnt;
+
+    /* Called from ISR - accumulate steps (acceleration included) to be dispatched in main loop,
+       saturated so a fast flick during main loop stall cannot flip the direction */
+    int16_t steps = encoder1_pending_steps + (int8_t)(step_cnt - last_step_cnt);
+
+    if (steps > INT8_MAX)
+        steps = INT8_MAX;
+    else if (steps < INT8_MIN)
+        steps = INT8_MIN;
+
+    encoder1_pending_steps = steps;
+    last_step_cnt = step_cnt;
+
+    (void)dir;
 }
 
 static struct rotary_encoder_cfg encoder1_cfg = 
@@ -317,20 +442,62 @@ static struct rotary_encoder_cfg encoder1_cfg =
     .deinit_cb = NULL,
     .rotation_cb = encoder1_rotation_cb,
     .sub_steps_count = 4,
-    .irq_cfg = ROTARY_ENCODER_IRQ_CONFIG_NONE,
+    .irq_cfg = ROTARY_ENCODER_IRQ_CONFIG_AB,
     .debounce_counter_initial_value = 0,
+
+    .get_time_cb = system_timer_get,
+    .accel_threshold_ms = HAL_ENCODER_ACCEL_THRESHOLD_MS,
+    .accel_max = HAL_ENCODER_ACCEL_MAX,
 };
 
 static struct rotary_encoder_obj encoder1_obj;
 
+static void exti_encoder_cb(void)
+{
+    rotary_encoder_process(&encoder1_obj);
+}
+
 /* USART */
+
+static bool usart0_rxc_cb(volatile uint8_t data_received, volatile bool error)
+{
+    if (hal_serial_rx_cb)
+        hal_serial_rx_cb(data_received, error);
+
+    return true; // Keep RX interrupt enabled
+}
+
+_Static_assert(USART_BAUDRATE_IS_VALID(F_CPU, HAL_SERIAL_BAUDRATE_MEDIUM, USART_FIXED_BAUDRATE_DOUBLE_SPEED), "HAL_SERIAL_BAUDRATE_MEDIUM error too high");
+_Static_assert(USART_BAUDRATE_IS_VALID(F_CPU, HAL_SERIAL_BAUDRATE_HIGH, USART_FIXED_BAUDRATE_DOUBLE_SPEED), "HAL_SERIAL_BAUDRATE_HIGH error too high");
+
+struct hal_serial_profile
+{
+    uint32_t baudrate;
+    uint16_t ubrr;
+};
+
+#define HAL_SERIAL_PROFILE(baudrate) {baudrate, USART_UBRR(F_CPU, baudrate, USART_FIXED_BAUDRATE_DOUBLE_SPEED)}
+
+/* Register values precomputed - no 32-bit division at runtime */
+static const struct hal_serial_profile hal_serial_profiles[] =
+{
+    HAL_SERIAL_PROFILE(USART_FIXED_BAUDRATE),
+    HAL_SERIAL_PROFILE(HAL_SERIAL_BAUDRATE_MEDIUM),
+    HAL_SERIAL_PROFILE(HAL_SERIAL_BAUDRATE_HIGH),
+};
+
 static struct usart_cfg usart0_cfg =
 {
     .mode = USART_MODE_ASYMC,
-    .rx_tx = USART_TX_ENABLE,
+    .rx_tx = USART_TX_ENABLE | USART_RX_ENABLE,
     .data_size = USART_DATASIZE_8_BIT,
     .parity = USART_PARITY_DISABLED,
     .stop_bits = USART_STOP_BITS_1,
+
+    /* RX interrupt driven, TX blocking */
+    .udre_cb = NULL,
+    .rxc_cb = usart0_rxc_cb,
+    .txc_cb = NULL,
 };
 
 /* TWI */
@@ -340,21 +507,42 @@ static struct twi_cfg twi1_cfg =
     .pull_up_en = false,
 };
 
+/* Status of the last failed transfer (fault journal detail) */
+static enum twi_status twi1_last_error;
+
+static bool twi1_handle_status(enum twi_status status)
+{
+    if (status == TWI_STATUS_OK)
+        return true;
+
+    twi1_last_error = status;
+
+    /* Slave could have been left in the middle of a byte, holding SDA low - release the bus before retry */
+    if (status == TWI_STATUS_TIMEOUT || status == TWI_STATUS_START_ERROR)
+        twi_bus_recover();
+
+    return false;
+}
+
 /* RTC - DS1307 */
 
 bool ds1307_io_init_cb1(void)
 {
-    return twi_init(&twi1_cfg);
+    if (!twi_init(&twi1_cfg))
+        return false;
+
+    /* Reset could have interrupted a transfer */
+    return twi1_handle_status(twi_bus_recover());
 }
 
 bool ds1307_serial_send_cb1(uint8_t device_addr, uint8_t *data, uint16_t len)
 {
-    return twi_send(device_addr, data, len, true);
+    return twi1_handle_status(twi_send(device_addr, data, len, true));
 }
 
 bool ds1307_serial_receive_cb1(uint8_t device_addr, uint8_t *data, uint16_t len)
 {
-    return twi_receive(device_addr, data, len);
+    return twi1_handle_status(twi_receive(device_addr, data, len));
 }
 
 static struct ds1307_cfg rtc_cfg = 
@@ -371,7 +559,7 @@ struct ds1307_obj rtc_obj;
 
 static void exti_sqw_cb(void)
 {
-    if (!gpio_get(HAL_SQW_PORT, HAL_SQW_PIN))
+    if (!gpio_static_get(HAL_SQW_PORT, HAL_SQW_PIN))
         hal_exti_sqw_cb();  
 }
 
@@ -379,20 +567,20 @@ static void exti_sqw_cb(void)
 
 static void mas6181b1_io_init_cb(void)
 {
-    gpio_init(HAL_MAS6181B_PWR_DOWN_PORT, HAL_MAS6181B_PWR_DOWN_PIN, true, false);
-    gpio_init(HAL_MAS6181B_OUT_PORT, HAL_MAS6181B_OUT_PIN, false, false);
+    gpio_static_init(HAL_MAS6181B_PWR_DOWN_PORT, HAL_MAS6181B_PWR_DOWN_PIN, true, false);
+    gpio_static_init(HAL_MAS6181B_OUT_PORT, HAL_MAS6181B_OUT_PIN, false, false);
 }
 
 static void mas6181b1_pwr_down_cb(bool pwr_down)
 {
     /* Open collector */
-    gpio_init(HAL_MAS6181B_PWR_DOWN_PORT, HAL_MAS6181B_PWR_DOWN_PIN, !pwr_down, false);
-    gpio_set(HAL_MAS6181B_PWR_DOWN_PORT, HAL_MAS6181B_PWR_DOWN_PIN, pwr_down);
+    gpio_static_init(HAL_MAS6181B_PWR_DOWN_PORT, HAL_MAS6181B_PWR_DOWN_PIN, !pwr_down, false);
+    gpio_static_set(HAL_MAS6181B_PWR_DOWN_PORT, HAL_MAS6181B_PWR_DOWN_PIN, pwr_down);
 }
 
 static bool mas6181b1_get_cb(void)
 {
-    return gpio_get(HAL_MAS6181B_OUT_PORT, HAL_MAS6181B_OUT_PIN);
+    return gpio_static_get(HAL_MAS6181B_OUT_PORT, HAL_MAS6181B_OUT_PIN);
 }
 
 static struct mas6181b_cfg mas6181b1_cfg = 
@@ -413,16 +601,50 @@ static void exti_mas6181B_cb(void)
     uint16_t time_diff = current_time - last_time;
     last_time = current_time;
 
-    hal_dcf_cb(time_diff, gpio_get(HAL_MAS6181B_OUT_PORT, HAL_MAS6181B_OUT_PIN));
+    hal_dcf_cb(time_diff, gpio_static_get(HAL_MAS6181B_OUT_PORT, HAL_MAS6181B_OUT_PIN));
+}
+
+/* PCINT[7:0] group shared by DCF77 receiver output and button */
+
+_Static_assert(HAL_BUTTON_PORT == HAL_MAS6181B_OUT_PORT, "Button and DCF77 receiver output have to share PCINT[7:0] group");
+
+static uint8_t pcint0_prev_pins;
+
+static void exti_pcint0_group_cb(void)
+{
+    /* Group has single vector, so changed pin is found by comparing with previous state */
+    uint8_t pins = *gpio_static_pin_reg(HAL_MAS6181B_OUT_PORT);
+    uint8_t changed = pins ^ pcint0_prev_pins;
+    pcint0_prev_pins = pins;
+
+    if (changed & (1 << HAL_MAS6181B_OUT_PIN))
+        exti_mas6181B_cb();
+
+    if (changed & (1 << HAL_BUTTON_PIN))
+        button_irq_handler(&button1_obj);
 }
 
 //------------------------------------------------------------------------------
 
 void hal_init(void)
 {
-    /* Watchdog */
+    /* Watchdog (disabled at startup by reset_cause) */
     wdt_enable(WDTO_8S);
 
+    /* Fault journal - task or ISR interrupted by reset is still kept in profiler context */
+    fault_journal_init(reset_cause_get(), profiler_get_context());
+    profiler_set_context(PROFILER_CONTEXT_INIT);
+
+    /* Warm boot - peripherals stayed powered and application state survived reset */
+    warm_boot = reset_cause_is_warm() && warm_state.magic == HAL_WARM_STATE_MAGIC && (uint8_t)(warm_state.check ^ warm_state.flags) == 0xFF;
+
+    if (!warm_boot)
+        hal_set_warm_flags(0);
+
+    /* LCD controller could have been reset by brown-out as well, battery backed RTC keeps its configuration */
+    lcd_cfg.warm_start = warm_boot && reset_cause_get() == RESET_CAUSE_WATCHDOG;
+    rtc_cfg.warm_start = warm_boot;
+
     /* Power down */
     power_adc_disable();
     power_spi_disable();
@@ -430,12 +652,18 @@ void hal_init(void)
     /* System timer */
     system_timer_init();
 
+    /* Profiler (Timer1 as cycle counter in profiling build only) */
+    profiler_init();
+
     /* LED */
-    gpio_init(HAL_LED_PORT, HAL_LED_PIN, true, false);
-    gpio_set(HAL_LED_PORT, HAL_LED_PIN, false);
+    gpio_static_init(HAL_LED_PORT, HAL_LED_PIN, true, false);
+    gpio_static_set(HAL_LED_PORT, HAL_LED_PIN, false);
 
     /* Buzzer */
     buzzer_init(&buzzer1_obj, &buzzer1_cfg);
+#if BUZZER_USE_SEQUENCER
+    system_timer_set_tick_cb(system_tick_cb);
+#endif
 
     /* LCD */
     hd44780_init(&lcd_obj, &lcd_cfg);
@@ -446,37 +674,60 @@ void hal_init(void)
     /* Rotary encoder */
     rotary_encoder_init(&encoder1_obj, &encoder1_cfg);
 
+    exti_init(HAL_ENCODER_A_EXTI_ID, HAL_ENCODER_EXTI_TRIGGER, exti_encoder_cb);
+    exti_enable(HAL_ENCODER_A_EXTI_ID, true);
+
+    exti_init(HAL_ENCODER_B_EXTI_ID, HAL_ENCODER_EXTI_TRIGGER, exti_encoder_cb);
+    exti_enable(HAL_ENCODER_B_EXTI_ID, true);
+
     /* External interrupts */
-    exti_init(HAL_MAS6181B_EXTI_ID, HAL_MAS6181B_EXTI_TRIGGER, exti_mas6181B_cb);
+    pcint0_prev_pins = *gpio_static_pin_reg(HAL_MAS6181B_OUT_PORT);
+
+    exti_init(HAL_MAS6181B_EXTI_ID, HAL_MAS6181B_EXTI_TRIGGER, exti_pcint0_group_cb);
     exti_enable(HAL_MAS6181B_EXTI_ID, true); 
 
+    exti_init(HAL_BUTTON_EXTI_ID, HAL_BUTTON_EXTI_TRIGGER, exti_pcint0_group_cb);
+    exti_enable(HAL_BUTTON_EXTI_ID, true);
+
     exti_init(HAL_SQW_EXTI_ID, HAL_SQW_EXTI_TRIGGER, exti_sqw_cb);
     exti_enable(HAL_SQW_EXTI_ID, true);
 
     /* DS1307 */
     uint8_t retries = HAL_DS1307_COMM_RETRY_COUNT;
-    while (retries-- && !ds1307_init(&rtc_obj, &rtc_cfg)) {};
+    while (!ds1307_init(&rtc_obj, &rtc_cfg))
+    {
+        if (!--retries)
+            hal_fault_reset(HAL_FAULT_RTC_INIT);
+    }
 
-    if (retries == 0)
-        hal_system_reset();
+    /* Time is not trusted if RTC oscillator was halted */
+    if (warm_boot && !ds1307_is_running(&rtc_obj))
+        warm_boot = false;
 
     /* MAS6181B */
     mas6181b_init(&mas6181b1_obj, &mas6181b1_cfg);
 
     /* USART */
     usart_init(&usart0_cfg);
+    usart_receive(NULL, 0); // Enables RX interrupt
+
+    profiler_set_context(PROFILER_CONTEXT_IDLE);
     
     sei();
 }
 
 void hal_process(void)
 {
+#if !BUZZER_USE_SEQUENCER
     buzzer_process(&buzzer1_obj);
+#endif
     button_process(&button1_obj);
-    rotary_encoder_process(&encoder1_obj);
+    hal_rotary_encoder_process();
 
     wdt_reset();
 
+    fault_journal_process(system_timer_get());
+
     set_sleep_mode(SLEEP_MODE_IDLE);
     sleep_mode();
 }
@@ -487,9 +738,21 @@ void hal_system_reset(void)
     while (1); 
 }
 
+void hal_fault_reset(enum hal_fault fault)
+{
+    hal_set_fault(fault);
+    hal_system_reset();
+}
+
+void hal_set_fault(enum hal_fault fault)
+{
+    /* TWI status tells which transfer phase failed (RTC faults only) */
+    fault_journal_set_fault(fault, fault == HAL_FAULT_NONE ? TWI_STATUS_OK : twi1_last_error);
+}
+
 void hal_led_set(bool state)
 {
-    gpio_set(HAL_LED_PORT, HAL_LED_PIN, state);
+    gpio_static_set(HAL_LED_PORT, HAL_LED_PIN, state);
 }
 
 void hal_lcd_clear(void)
@@ -503,6 +766,12 @@ void hal_lcd_print(const char* str, uint8_t row, uint8_t col)
     hd44780_print(&lcd_obj, str);
 }
 
+void hal_lcd_print_P(const char* str, uint8_t row, uint8_t col)
+{
+    hd44780_set_pos(&lcd_obj, row, col);
+    hd44780_print_P(&lcd_obj, str);
+}
+
 void hal_lcd_set_cursor(uint8_t row, uint8_t col)
 {
     hd44780_set_pos(&lcd_obj, row, col);
@@ -523,6 +792,11 @@ void hal_audio_set_pattern(struct buzzer_note *pattern, uint16_t pattern_len, ui
     buzzer_set_pattern(&buzzer1_obj, pattern, pattern_len, bpm);
 }
 
+void hal_audio_set_pattern_P(const struct buzzer_note *pattern, uint16_t pattern_len, uint16_t bpm)
+{
+    buzzer_set_pattern_P(&buzzer1_obj, pattern, pattern_len, bpm);
+}
+
 void hal_audio_stop(void)
 {
     buzzer_stop_pattern(&buzzer1_obj);
@@ -540,45 +814,113 @@ void hal_button_process(void)
 
 void hal_rotary_encoder_process(void)
 {
-    rotary_encoder_process(&encoder1_obj);
+    int8_t steps;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        steps = encoder1_pending_steps;
+        encoder1_pending_steps = 0;
+    }
+
+    if (steps)
+        hal_encoder_rotation_cb(steps);
 }
 
-void hal_set_time(struct ds1307_time *time)
+bool hal_set_time(struct ds1307_time *time)
 {
     uint8_t retries = HAL_DS1307_COMM_RETRY_COUNT;
-    while (retries-- && !ds1307_set_time(&rtc_obj, time)) {};
+    while (!ds1307_set_time(&rtc_obj, time))
+    {
+        if (!--retries)
+        {
+            hal_set_fault(HAL_FAULT_RTC_SET_TIME);
+            return false;
+        }
+    }
+
+    /* RTC works again - later unrelated reset is not blamed on old transfer failure */
+    hal_set_fault(HAL_FAULT_NONE);
 
-    if (retries == 0)
-        hal_system_reset();
+    return true;
 }
 
-void hal_get_time(struct ds1307_time *time)
+bool hal_get_time(struct ds1307_time *time)
 {
+    /* Time is not changed on failure */
+    struct ds1307_time rtc_time;
+
     uint8_t retries = HAL_DS1307_COMM_RETRY_COUNT;
-    while (retries-- && !ds1307_get_time(&rtc_obj, time)) {};
+    while (!ds1307_get_time(&rtc_obj, &rtc_time))
+    {
+        if (!--retries)
+        {
+            hal_set_fault(HAL_FAULT_RTC_GET_TIME);
+            return false;
+        }
+    }
+
+    hal_set_fault(HAL_FAULT_NONE);
 
-    if (retries == 0)
-        hal_system_reset();
+    *time = rtc_time;
+
+    return true;
 }
 
-void hal_set_alarm(struct hal_timestamp *alarm)
+bool hal_set_alarm(uint8_t id, struct hal_alarm *alarm)
 {
-    eeprom_write_block((const void *)alarm, (void *)0x00, sizeof(struct hal_timestamp));
+    if (id >= HAL_ALARMS_COUNT)
+        return false;
+
+    eeprom_update_block((const void *)alarm, (void *)(HAL_EEPROM_ALARMS_ADDR + id * sizeof(struct hal_alarm)), sizeof(struct hal_alarm));
+
+    return true;
 }
 
-void hal_get_alarm(struct hal_timestamp *alarm)
+bool hal_get_alarm(uint8_t id, struct hal_alarm *alarm)
 {
-    eeprom_read_block((void *)alarm, (const void *)0x00, sizeof(struct hal_timestamp));
+    if (id >= HAL_ALARMS_COUNT)
+        return false;
+
+    eeprom_read_block((void *)alarm, (const void *)(HAL_EEPROM_ALARMS_ADDR + id * sizeof(struct hal_alarm)), sizeof(struct hal_alarm));
+
+    /* Erased slot - first alarm is taken over from previous versions (every day) */
+    if (alarm->hours > 23 && id == 0)
+    {
+        eeprom_read_block((void *)alarm, (const void *)HAL_EEPROM_LEGACY_ALARM_ADDR, HAL_EEPROM_LEGACY_ALARM_SIZE);
+        alarm->weekdays = HAL_ALARM_EVERY_DAY;
+    }
+
+    if (alarm->hours > 23 || alarm->minutes > 59 || alarm->is_enabled > 1)
+        *alarm = (struct hal_alarm){.weekdays = HAL_ALARM_EVERY_DAY};
+
+    return true;
 }
 
 void hal_set_timezone(int8_t *tz)
 {
-    eeprom_write_block((const void *)tz, (void *)(0x00 + sizeof(struct hal_timestamp)), sizeof(int8_t));
+    eeprom_write_block((const void *)tz, (void *)HAL_EEPROM_TIMEZONE_ADDR, sizeof(int8_t));
 }
 
 void hal_get_timezone(int8_t *tz)
 {
-    eeprom_read_block((void *)tz, (const void *)(0x00 + sizeof(struct hal_timestamp)), sizeof(int8_t));
+    eeprom_read_block((void *)tz, (const void *)HAL_EEPROM_TIMEZONE_ADDR, sizeof(int8_t));
+}
+
+bool hal_is_warm_boot(void)
+{
+    return warm_boot;
+}
+
+uint8_t hal_get_warm_flags(void)
+{
+    return warm_state.flags;
+}
+
+void hal_set_warm_flags(uint8_t flags)
+{
+    warm_state.magic = HAL_WARM_STATE_MAGIC;
+    warm_state.flags = flags;
+    warm_state.check = ~flags;
 }
 
 bool hal_time_is_reset(void)
@@ -586,9 +928,72 @@ bool hal_time_is_reset(void)
     return !ds1307_is_running(&rtc_obj);
 }
 
-void hal_send_time_info(struct ds1307_time *time)
+void hal_serial_send(const uint8_t *data, uint8_t len)
+{
+    usart_send((uint8_t*)data, len);
+}
+
+static const struct hal_serial_profile *hal_serial_find_profile(uint32_t baudrate)
+{
+    for (uint8_t i = 0; i < sizeof(hal_serial_profiles) / sizeof(hal_serial_profiles[0]); i++)
+    {
+        if (hal_serial_profiles[i].baudrate == baudrate)
+            return &hal_serial_profiles[i];
+    }
+
+    return NULL;
+}
+
+bool hal_serial_baudrate_is_supported(uint32_t baudrate)
+{
+    return hal_serial_find_profile(baudrate) != NULL;
+}
+
+bool hal_serial_set_baudrate(uint32_t baudrate)
+{
+    const struct hal_serial_profile *profile = hal_serial_find_profile(baudrate);
+
+    if (!profile)
+        return false;
+
+    usart_set_ubrr(profile->ubrr);
+
+    return true;
+}
+
+void hal_serial_reset_baudrate(void)
+{
+    usart_set_ubrr(hal_serial_profiles[0].ubrr);
+}
+
+void hal_profiler_task_begin(uint8_t task_id)
+{
+    profiler_task_begin(task_id);
+}
+
+void hal_profiler_task_end(uint8_t task_id)
+{
+    profiler_task_end(task_id);
+}
+
+bool hal_get_profiling_stats(uint8_t id, struct profiler_stats *stats)
+{
+    return profiler_get_stats(id, stats);
+}
+
+void hal_reset_profiling_info(void)
+{
+    profiler_reset();
+}
+
+void hal_get_ram_usage(struct stack_monitor_ram_usage *usage)
+{
+    stack_monitor_get_ram_usage(usage);
+}
+
+bool hal_get_fault_journal_entry(uint8_t index, struct fault_journal_entry *entry)
 {
-    usart_send((uint8_t*)time, sizeof(*time));
+    return fault_journal_read(index, entry);
 }
 
 bool hal_dcf_get_state(void)
@@ -25,18 +25,37 @@
 
 #include <stdint.h>
 
+#include <avr/pgmspace.h> /* PROGMEM tables and PSTR strings for *_P functions */
+
+#include <button.h> /* Do not duplicate enum button_event */
 #include <buzzer.h> /* Do not duplicate struct buzzer_note */
 #include <ds1307.h> /* Do not duplicate struct ds1307_time */
+#include <profiler.h> /* Do not duplicate struct profiler_stats */
+#include <stack_monitor.h> /* Do not duplicate struct stack_monitor_ram_usage */
+#include <fault_journal.h> /* Do not duplicate struct fault_journal_entry */
 
 //------------------------------------------------------------------------------
 
-struct hal_timestamp
+#define HAL_ALARMS_COUNT 4
+#define HAL_ALARM_EVERY_DAY 0x7F
+
+struct hal_alarm
 {
     uint8_t hours;
     uint8_t minutes;
     uint8_t is_enabled;
+    uint8_t weekdays;   /* Bit 0 Monday ... bit 6 Sunday */
 }__attribute__((packed));
 
+/* Fault codes stored in fault journal */
+enum hal_fault
+{
+    HAL_FAULT_NONE,
+    HAL_FAULT_RTC_INIT,
+    HAL_FAULT_RTC_SET_TIME,
+    HAL_FAULT_RTC_GET_TIME,
+};
+
 //------------------------------------------------------------------------------
 
 /// @brief Initializes hardware abstraction layer
@@ -50,6 +69,16 @@ void hal_process(void);
 /// @brief Resets micronotroller
 void hal_system_reset(void);
 
+/// @brief Records fault in fault journal and resets microcontroller
+/// @param fault fault code @ref enum hal_fault
+void hal_fault_reset(enum hal_fault fault);
+
+/// @brief Records fault in fault journal without reset
+/// @note Journaled with the next reset, the last recorded fault wins - RTC faults are cleared (HAL_FAULT_NONE)
+///       by the next successful RTC transfer, so later unrelated reset is not blamed on them
+/// @param fault fault code @ref enum hal_fault
+void hal_set_fault(enum hal_fault fault);
+
 /// @brief Sets LED state
 void hal_led_set(bool state);
 
@@ -59,6 +88,9 @@ void hal_lcd_clear(void);
 /// @brief Prints string on LCD display
 void hal_lcd_print(const char* str, uint8_t row, uint8_t col);
 
+/// @brief Prints string placed in program memory (PROGMEM / PSTR) on LCD display
+void hal_lcd_print_P(const char* str, uint8_t row, uint8_t col);
+
 /// @brief Sets cursor position on LCD display
 /// @param row selected row
 /// @param col selected column
@@ -79,33 +111,48 @@ void hal_lcd_putc(const char ch);
 /// @param bpm selected audio pattern BPM
 void hal_audio_set_pattern(struct buzzer_note *pattern, uint16_t pattern_len, uint16_t bpm);
 
+/// @brief Sets audio pattern placed in program memory (PROGMEM) for buzzer
+/// @param pattern selected audio pattern array in program memory @ref struct buzzer_note
+/// @param pattern_len selected audio pattern array size in bytes
+/// @param bpm selected audio pattern BPM
+void hal_audio_set_pattern_P(const struct buzzer_note *pattern, uint16_t pattern_len, uint16_t bpm);
+
 /// @brief Stops audio pattern for buzzer
 void hal_audio_stop(void);
 
-/// @brief Processes audio pattern for buzzer
+/// @brief Processes audio pattern for buzzer (no-op in sequencer build - pattern is advanced from system timer ISR)
 void hal_audio_process(void);
 
-/// @brief Processes button polling
+/// @brief Processes button events (idle until pin change interrupt), reported via hal_button_event_cb
 void hal_button_process(void);
 
-/// @brief Processes encoder polling
+/// @brief Dispatches encoder steps accumulated in interrupts to hal_encoder_rotation_cb (signed, acceleration included)
 void hal_rotary_encoder_process(void);
 
 /// @brief Sets time on RTC
+/// @note Failure after all retries (with bus recovery) is recorded in fault journal, device is not reset
 /// @param time pointer to time structure @ref struct ds1307_time
-void hal_set_time(struct ds1307_time *time);
+/// @return true if time was set, otherwise false
+bool hal_set_time(struct ds1307_time *time);
 
 /// @brief  Gets time from RTC
-/// @param time pointer to time structure @ref struct ds1307_time
-void hal_get_time(struct ds1307_time *time);
-
-/// @brief Sets alarm on RTC
-/// @param alarm pointer to alarm structure @ref struct hal_timestamp
-void hal_set_alarm(struct hal_timestamp *alarm);
-
-/// @brief  Gets alarm from RTC
-/// @param alarm pointer to alarm structure @ref struct hal_timestamp
-void hal_get_alarm(struct hal_timestamp *alarm);
+/// @note Failure after all retries (with bus recovery) is recorded in fault journal, device is not reset
+/// @param time pointer to time structure @ref struct ds1307_time (not changed on failure)
+/// @return true if time was read, otherwise false
+bool hal_get_time(struct ds1307_time *time);
+
+/// @brief Sets alarm in EEPROM
+/// @param id alarm index (0 - HAL_ALARMS_COUNT - 1)
+/// @param alarm pointer to alarm structure @ref struct hal_alarm
+/// @return true if alarm was set, false for invalid index
+bool hal_set_alarm(uint8_t id, struct hal_alarm *alarm);
+
+/// @brief  Gets alarm from EEPROM
+/// @note Never set alarm is returned disabled at 00:00 every day
+/// @param id alarm index (0 - HAL_ALARMS_COUNT - 1)
+/// @param alarm pointer to alarm structure @ref struct hal_alarm
+/// @return true if alarm was read, false for invalid index
+bool hal_get_alarm(uint8_t id, struct hal_alarm *alarm);
 
 /// @brief Sets timezone
 /// @param tz pointer to timezone value
@@ -115,13 +162,70 @@ void hal_set_timezone(int8_t *tz);
 /// @param tz pointer to timezone value
 void hal_get_timezone(int8_t *tz);
 
+/// @brief Checks if device was restarted by watchdog or brown-out with valid warm state and running RTC
+/// @note Power-on and external reset are always cold boots, warm state flags are cleared then
+/// @return true if initialization was shortened and application state can be restored
+bool hal_is_warm_boot(void);
+
+/// @brief Gets application flags kept in .noinit memory over warm reset
+/// @return flags set by @ref hal_set_warm_flags before reset (0 after cold boot)
+uint8_t hal_get_warm_flags(void);
+
+/// @brief Sets application flags kept in .noinit memory over warm reset
+/// @param flags application defined flags
+void hal_set_warm_flags(uint8_t flags);
+
 /// @brief Checks if RTC is running
 /// @return true if RTC is running, otherwise false
 bool hal_time_is_reset(void);
 
-/// @brief Sends time info via USART
-/// @param time current time structure
-void hal_send_time_info(struct ds1307_time *time);
+/// @brief Sends data via USART (blocking)
+/// @note Received bytes are passed from RX interrupt to hal_serial_rx_cb
+/// @param data data to send pointer
+/// @param len data to send length
+void hal_serial_send(const uint8_t *data, uint8_t len);
+
+/// @brief Checks if given baud rate is one of serial port profiles
+/// @param baudrate baud rate to check
+/// @return true if baud rate can be set with @ref hal_serial_set_baudrate
+bool hal_serial_baudrate_is_supported(uint32_t baudrate);
+
+/// @brief Switches serial port to given baud rate profile
+/// @note Waits until pending transmission is completed, bytes being received are lost
+/// @param baudrate requested baud rate (9600, 31250 or 62500 at 1 MHz)
+/// @return true if switched, false if baud rate is not supported (baud rate is not changed)
+bool hal_serial_set_baudrate(uint32_t baudrate);
+
+/// @brief Switches serial port back to baud rate used after reset
+void hal_serial_reset_baudrate(void);
+
+/// @brief Starts cycle measurement of main loop task (no-op if profiling is disabled)
+/// @param task_id task index
+void hal_profiler_task_begin(uint8_t task_id);
+
+/// @brief Ends cycle measurement of main loop task (no-op if profiling is disabled)
+/// @param task_id task index
+void hal_profiler_task_end(uint8_t task_id);
+
+/// @brief Gets ISR or task cycle statistics
+/// @param id section id @ref enum profiler_id
+/// @param stats output statistics structure pointer @ref struct profiler_stats
+/// @return true if id is valid and profiling is enabled, otherwise false
+bool hal_get_profiling_stats(uint8_t id, struct profiler_stats *stats);
+
+/// @brief Resets ISR and task cycle statistics
+void hal_reset_profiling_info(void);
+
+/// @brief Gets RAM usage and stack high-water mark report (sizes in bytes)
+/// @param usage output structure pointer @ref struct stack_monitor_ram_usage
+void hal_get_ram_usage(struct stack_monitor_ram_usage *usage);
+
+/// @brief Gets fault journal entry
+/// @note Entry is added at every startup with reset cause, fault code, uptime and task or ISR id (@ref enum profiler_id) from before reset
+/// @param index entry index (0 for the newest)
+/// @param entry output entry pointer @ref struct fault_journal_entry
+/// @return true if entry exists, otherwise false
+bool hal_get_fault_journal_entry(uint8_t index, struct fault_journal_entry *entry);
 
 /// @brief Gets actual DCF77 receiver output state
 /// @return true if DCF77 receiver output is high, otherwise false
@@ -1,8 +1,8 @@
 # platform targets - will be included in hal/CMakeLists.txt
 
-add_subdirectory(platforms/${HW_VERSION})
-
 # Platform specific defines
+add_definitions(-DEXTI_USE_INT0_ISR=1)
+add_definitions(-DEXTI_USE_INT1_ISR=1)
 add_definitions(-DEXTI_USE_PCINT0_ISR=1)
 add_definitions(-DEXTI_USE_PCINT1_ISR=1)
 
@@ -14,13 +14,32 @@ add_definitions(-DTIMER_USE_TIMER0_COMPA_ISR=1)
 add_definitions(-DTWI_USE_FIXED_SPEED=1)
 add_definitions(-DTWI_FIXED_SPEED=100000UL)
 
+# Baud rate after reset - error is checked at build time, other profiles can be negotiated at runtime
+set(SERIAL_BAUDRATE 9600 CACHE STRING "Serial baud rate after reset")
+set_property(CACHE SERIAL_BAUDRATE PROPERTY STRINGS 9600 31250 62500)
+
 add_definitions(-DUSART_USE_FIXED_BAUDRATE=1)
 add_definitions(-DUSART_FIXED_BAUDRATE_DOUBLE_SPEED=1)
-add_definitions(-DUSART_FIXED_BAUDRATE=9600)
+add_definitions(-DUSART_FIXED_BAUDRATE=${SERIAL_BAUDRATE}UL)
+add_definitions(-DUSART_USE_IRQ=1)
+
+add_definitions(-DROTARY_ENCODER_USE_IRQ=1)
+add_definitions(-DBUTTON_USE_IRQ=1)
+add_definitions(-DBUZZER_USE_SEQUENCER=1)
 
-add_definitions(-DROTARY_ENCODER_USE_POLLING=1)
-add_definitions(-DBUTTON_USE_POLLING=1)
+# Running task / ISR id kept over reset for fault journal
+add_definitions(-DPROFILER_USE_CONTEXT=1)
 
+# Profiling build - Timer1 is used as free-running CPU cycle counter
+option(PROFILING "Enable ISR and task cycle profiling" OFF)
+
+if (PROFILING)
+    add_definitions(-DPROFILER_USE_PROFILING=1)
+    add_definitions(-DTIMER_USE_TIMER1=1)
+    add_definitions(-DTIMER_USE_TIMER1_OVF_ISR=1)   # Task cycle counter extension
+endif()
+
+add_subdirectory(platforms/${HW_VERSION})
 add_subdirectory(drivers)
 add_subdirectory(ext_drivers)
 add_subdirectory(startup)
\ No newline at end of file
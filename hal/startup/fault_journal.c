@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#include "fault_journal.h"
+
+#include <stddef.h>
+
+#include <avr/eeprom.h>
+
+//------------------------------------------------------------------------------
+
+#define FAULT_JOURNAL_SEQ_EMPTY 0xFF
+#define FAULT_JOURNAL_PENDING_MAGIC 0xFA17
+
+#define FAULT_JOURNAL_NONE FAULT_JOURNAL_ENTRIES
+
+//------------------------------------------------------------------------------
+
+/* State of running firmware - survives reset without power loss, journaled at next startup */
+struct fault_journal_pending
+{
+    uint16_t magic;
+    uint8_t fault;
+    uint8_t detail;
+    uint32_t uptime_s;
+};
+
+struct fault_journal_ctx
+{
+    uint8_t newest;         /* Slot of the newest entry or FAULT_JOURNAL_NONE */
+    uint8_t newest_seq;
+    uint16_t uptime_stamp;
+};
+
+static struct fault_journal_pending pending __attribute__((section(".noinit")));
+
+static struct fault_journal_ctx ctx;
+
+//------------------------------------------------------------------------------
+
+static uint8_t *slot_addr(uint8_t slot)
+{
+    return (uint8_t *)(FAULT_JOURNAL_EEPROM_ADDR + slot * sizeof(struct fault_journal_entry));
+}
+
+static uint8_t next_seq(uint8_t seq)
+{
+    return (seq >= FAULT_JOURNAL_SEQ_EMPTY - 1) ? 0 : seq + 1;
+}
+
+static uint8_t read_seq(uint8_t slot)
+{
+    return eeprom_read_byte(slot_addr(slot));
+}
+
+/* Entries are written one after another, so the newest one is the last of consecutive sequence numbers */
+static void find_newest(void)
+{
+    ctx.newest = FAULT_JOURNAL_NONE;
+
+    for (uint8_t slot = 0; slot < FAULT_JOURNAL_ENTRIES; slot++)
+    {
+        uint8_t seq = read_seq(slot);
+
+        if (seq == FAULT_JOURNAL_SEQ_EMPTY)
+            continue;
+
+        if (read_seq((slot + 1) % FAULT_JOURNAL_ENTRIES) != next_seq(seq))
+        {
+            ctx.newest = slot;
+            ctx.newest_seq = seq;
+            return;
+        }
+    }
+}
+
+static void write_entry(uint8_t slot, const struct fault_journal_entry *entry)
+{
+    uint8_t *addr = slot_addr(slot);
+
+    /* Entry is not valid until all bytes are written - reset in the middle leaves empty slot */
+    eeprom_update_byte(addr, FAULT_JOURNAL_SEQ_EMPTY);
+
+    for (uint8_t offset = 1; offset < sizeof(*entry); offset++)
+        eeprom_update_byte(addr + offset, ((const uint8_t *)entry)[offset]);
+
+    eeprom_update_byte(addr, entry->seq);
+
+    ctx.newest = slot;
+    ctx.newest_seq = entry->seq;
+}
+
+//------------------------------------------------------------------------------
+
+void fault_journal_init(uint8_t reset_cause, uint8_t context)
+{
+    struct fault_journal_entry entry;
+    uint8_t slot;
+
+    find_newest();
+
+    entry.reset_cause = reset_cause;
+
+    if (pending.magic == FAULT_JOURNAL_PENDING_MAGIC)
+    {
+        entry.fault = pending.fault;
+        entry.detail = pending.detail;
+        entry.context = context;
+        entry.uptime_s = pending.uptime_s;
+    }
+    else
+    {
+        entry.fault = 0;
+        entry.detail = 0;
+        entry.context = 0xFF;
+        entry.uptime_s = FAULT_JOURNAL_UPTIME_UNKNOWN;
+    }
+
+    if (ctx.newest == FAULT_JOURNAL_NONE)
+    {
+        entry.seq = 0;
+        slot = 0;
+    }
+    else
+    {
+        entry.seq = next_seq(ctx.newest_seq);
+        slot = (ctx.newest + 1) % FAULT_JOURNAL_ENTRIES;
+    }
+
+    /* Written before anything else can reset the device (e.g. RTC init failing at every startup) */
+    write_entry(slot, &entry);
+
+    pending.magic = FAULT_JOURNAL_PENDING_MAGIC;
+    pending.fault = 0;
+    pending.detail = 0;
+    pending.uptime_s = 0;
+}
+
+void fault_journal_set_fault(uint8_t fault, uint8_t detail)
+{
+    pending.fault = fault;
+    pending.detail = detail;
+}
+
+void fault_journal_process(uint16_t time_ms)
+{
+    if ((uint16_t)(time_ms - ctx.uptime_stamp) >= 1000)
+    {
+        ctx.uptime_stamp += 1000;
+        pending.uptime_s++;
+    }
+}
+
+bool fault_journal_read(uint8_t index, struct fault_journal_entry *entry)
+{
+    if (!entry || index >= FAULT_JOURNAL_ENTRIES || ctx.newest == FAULT_JOURNAL_NONE)
+        return false;
+
+    uint8_t slot = (ctx.newest + FAULT_JOURNAL_ENTRIES - index) % FAULT_JOURNAL_ENTRIES;
+    uint8_t seq = ctx.newest_seq;
+
+    for (uint8_t i = 0; i < index; i++)
+        seq = (seq == 0) ? FAULT_JOURNAL_SEQ_EMPTY - 1 : seq - 1;
+
+    eeprom_read_block(entry, slot_addr(slot), sizeof(*entry));
+
+    /* Older entry does not exist yet or is being overwritten */
+    return entry->seq == seq;
+}
+
+//------------------------------------------------------------------------------
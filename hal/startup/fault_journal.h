@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#ifndef FAULT_JOURNAL_H_
+#define FAULT_JOURNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+#ifndef FAULT_JOURNAL_EEPROM_ADDR
+#define FAULT_JOURNAL_EEPROM_ADDR 0x10
+#endif
+
+#ifndef FAULT_JOURNAL_ENTRIES
+#define FAULT_JOURNAL_ENTRIES 8
+#endif
+
+#define FAULT_JOURNAL_EEPROM_SIZE (FAULT_JOURNAL_ENTRIES * sizeof(struct fault_journal_entry))
+
+/* Uptime before reset is not known after power loss (.noinit content is lost) */
+#define FAULT_JOURNAL_UPTIME_UNKNOWN 0xFFFFFFFFUL
+
+//------------------------------------------------------------------------------
+
+struct fault_journal_entry
+{
+    uint8_t seq;            /* Sequence number (0xFF marks empty or partially written entry) */
+    uint8_t reset_cause;    /* MCUSR flags captured at startup */
+    uint8_t fault;          /* Platform defined fault code which triggered reset (0 if none) */
+    uint8_t detail;         /* Platform defined fault detail (e.g. bus status) */
+    uint8_t context;        /* Platform defined id of task or ISR running before reset (valid with known uptime only) */
+    uint32_t uptime_s;      /* Time from previous startup to reset [s] */
+}__attribute__((packed));
+
+//------------------------------------------------------------------------------
+
+/// @brief Initializes journal and writes entry describing previous reset
+/// @note Fault, uptime and context are taken from .noinit memory, so they are valid after warm or external reset only,
+///       call it once at startup before anything which can reset the device - entry is written to EEPROM at once
+///       (blocking, up to ~30 ms)
+/// @param reset_cause reset cause flags captured at startup
+/// @param context id of task or ISR running before reset
+void fault_journal_init(uint8_t reset_cause, uint8_t context);
+
+/// @brief Records fault which is going to trigger reset
+/// @note Stored in .noinit memory and journaled at next startup, last call before reset wins
+/// @param fault platform defined fault code
+/// @param detail platform defined fault detail
+void fault_journal_set_fault(uint8_t fault, uint8_t detail);
+
+/// @brief Counts uptime reported by the next entry
+/// @note Should be called in the main loop at least once per second
+/// @param time_ms current system time [ms]
+void fault_journal_process(uint16_t time_ms);
+
+/// @brief Reads journal entry
+/// @param index entry index (0 for the newest)
+/// @param entry output entry pointer @ref struct fault_journal_entry
+/// @return true if entry exists, otherwise false
+bool fault_journal_read(uint8_t index, struct fault_journal_entry *entry);
+
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FAULT_JOURNAL_H_ */
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#include "reset_cause.h"
+
+#include <avr/io.h>
+#include <avr/wdt.h>
+
+//------------------------------------------------------------------------------
+
+_Static_assert(RESET_CAUSE_POWER_ON == (1 << PORF) && RESET_CAUSE_EXTERNAL == (1 << EXTRF) &&
+               RESET_CAUSE_BROWN_OUT == (1 << BORF) && RESET_CAUSE_WATCHDOG == (1 << WDRF), "MCUSR layout mismatch");
+
+/* Not cleared by .bss initialization, written before it */
+static uint8_t mcusr __attribute__((section(".noinit")));
+
+//------------------------------------------------------------------------------
+
+/* Executed after SP and zero register setup (.init2) and before .data / .bss initialization (.init4),
+   naked function is placed inline in startup code, so it must not return */
+__attribute__((naked, used, section(".init3")))
+static void capture_reset_cause(void)
+{
+    mcusr = MCUSR;
+    MCUSR = 0;
+    wdt_disable();
+}
+
+//------------------------------------------------------------------------------
+
+uint8_t reset_cause_get(void)
+{
+    return mcusr;
+}
+
+bool reset_cause_is_warm(void)
+{
+    return (mcusr & (RESET_CAUSE_WATCHDOG | RESET_CAUSE_BROWN_OUT)) && !(mcusr & (RESET_CAUSE_POWER_ON | RESET_CAUSE_EXTERNAL));
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#ifndef RESET_CAUSE_H_
+#define RESET_CAUSE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+/* MCUSR flags */
+enum reset_cause
+{
+    RESET_CAUSE_POWER_ON = 1 << 0,
+    RESET_CAUSE_EXTERNAL = 1 << 1,
+    RESET_CAUSE_BROWN_OUT = 1 << 2,
+    RESET_CAUSE_WATCHDOG = 1 << 3,
+};
+
+//------------------------------------------------------------------------------
+
+/// @brief Gets reset cause flags captured at startup
+/// @note MCUSR is read and cleared in .init3 (before .data / .bss initialization) and watchdog is disabled there,
+///       otherwise watchdog reset would be repeated with the shortest timeout before main
+/// @return reset cause flags @ref enum reset_cause (more than one can be set, e.g. power-on with brown-out)
+uint8_t reset_cause_get(void);
+
+/// @brief Checks if MCU was reset while peripherals stayed powered
+/// @return true for watchdog or brown-out reset without power-on or external reset
+bool reset_cause_is_warm(void);
+
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RESET_CAUSE_H_ */
+
+//------------------------------------------------------------------------------
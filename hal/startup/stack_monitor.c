@@ -0,0 +1,73 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#include "stack_monitor.h"
+
+#include <avr/io.h>
+
+//------------------------------------------------------------------------------
+
+/* Symbols provided by avr-libc default linker script */
+extern uint8_t __data_start;
+extern uint8_t __data_end;
+extern uint8_t __bss_start;
+extern uint8_t __heap_start; /* End of .bss and .noinit */
+
+//------------------------------------------------------------------------------
+
+/* Executed after SP and zero register setup (.init2) and before .data / .bss initialization (.init4),
+   must not use stack - naked function is placed inline in startup code, so it must not return */
+__attribute__((naked, used, section(".init3")))
+static void paint_stack(void)
+{
+    uint8_t *ptr = &__heap_start;
+
+    while (ptr <= (uint8_t *)RAMEND)
+        *ptr++ = STACK_MONITOR_PAINT_PATTERN;
+}
+
+//------------------------------------------------------------------------------
+
+uint16_t stack_monitor_get_max_used(void)
+{
+    const uint8_t *ptr = &__heap_start;
+
+    while (ptr <= (const uint8_t *)RAMEND && *ptr == STACK_MONITOR_PAINT_PATTERN)
+        ptr++;
+
+    return (uint16_t)((const uint8_t *)RAMEND - ptr + 1);
+}
+
+void stack_monitor_get_ram_usage(struct stack_monitor_ram_usage *usage)
+{
+    if (!usage)
+        return;
+
+    usage->ram_size = RAMEND - RAMSTART + 1;
+    usage->data_size = &__data_end - &__data_start;
+    usage->bss_size = &__heap_start - &__bss_start;
+    usage->heap_size = 0;
+    usage->stack_size = (const uint8_t *)RAMEND - &__heap_start + 1;
+    usage->stack_max_used = stack_monitor_get_max_used();
+    usage->stack_margin = usage->stack_size - usage->stack_max_used;
+    usage->stack_current = RAMEND - SP;
+}
+
+//------------------------------------------------------------------------------
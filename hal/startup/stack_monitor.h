@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#ifndef STACK_MONITOR_H_
+#define STACK_MONITOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+#ifndef STACK_MONITOR_PAINT_PATTERN
+#define STACK_MONITOR_PAINT_PATTERN 0xC5
+#endif
+
+//------------------------------------------------------------------------------
+
+struct stack_monitor_ram_usage
+{
+    uint16_t ram_size;          /* Total SRAM size */
+    uint16_t data_size;         /* Initialized variables (.data) */
+    uint16_t bss_size;          /* Zero-initialized and non-initialized variables (.bss, .noinit) */
+    uint16_t heap_size;         /* Always 0 - dynamic allocation is not used */
+    uint16_t stack_size;        /* Space left for stack between static data and RAMEND */
+    uint16_t stack_max_used;    /* Stack high-water mark since reset */
+    uint16_t stack_margin;      /* Stack bytes never touched since reset */
+    uint16_t stack_current;     /* Stack bytes currently in use */
+};
+
+//------------------------------------------------------------------------------
+
+/// @brief Gets stack high-water mark
+/// @note Memory between end of static data and RAMEND is painted with STACK_MONITOR_PAINT_PATTERN at startup (.init3),
+///       high-water mark is found by scanning for the first overwritten byte, so the call takes a few ms at 1 MHz
+/// @return maximum number of stack bytes used since reset
+uint16_t stack_monitor_get_max_used(void);
+
+/// @brief Gets RAM usage report
+/// @param usage output structure pointer @ref struct stack_monitor_ram_usage
+void stack_monitor_get_ram_usage(struct stack_monitor_ram_usage *usage);
+
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STACK_MONITOR_H_ */
+
+//------------------------------------------------------------------------------
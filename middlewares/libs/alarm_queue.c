@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+#include "alarm_queue.h"
+
+#include <stddef.h>
+
+#include <civil_time.h>
+
+//------------------------------------------------------------------------------
+
+static uint32_t next_occurrence(const struct alarm_queue_entry *entry, uint32_t now)
+{
+    uint16_t days = now / CIVIL_TIME_SECONDS_PER_DAY;
+    uint8_t weekday = civil_time_weekday(days);
+
+    uint32_t time = days * CIVIL_TIME_SECONDS_PER_DAY + entry->minute_of_day * 60UL;
+
+    /* Up to 8 days - the same weekday next week when today's minute has passed */
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        if (time > now && (entry->weekdays & (1 << (weekday - 1))))
+            break;
+
+        time += CIVIL_TIME_SECONDS_PER_DAY;
+        weekday = weekday % 7 + 1;
+    }
+
+    return time;
+}
+
+static void insert(struct alarm_queue *queue, const struct alarm_queue_entry *entry)
+{
+    uint8_t i = queue->count++;
+
+    /* Entry fired later than equal ones goes behind them */
+    for (; i > 0 && queue->entries[i - 1].next > entry->next; i--)
+        queue->entries[i] = queue->entries[i - 1];
+
+    queue->entries[i] = *entry;
+}
+
+static void remove_at(struct alarm_queue *queue, uint8_t index)
+{
+    queue->count--;
+
+    for (uint8_t i = index; i < queue->count; i++)
+        queue->entries[i] = queue->entries[i + 1];
+}
+
+//------------------------------------------------------------------------------
+
+void alarm_queue_init(struct alarm_queue *queue)
+{
+    queue->count = 0;
+}
+
+bool alarm_queue_set(struct alarm_queue *queue, uint8_t id, uint8_t hours, uint8_t minutes, uint8_t weekdays, uint32_t now)
+{
+    if (hours > 23 || minutes > 59)
+        return false;
+
+    for (uint8_t i = 0; i < queue->count; i++)
+    {
+        if (queue->entries[i].id == id)
+        {
+            remove_at(queue, i);
+            break;
+        }
+    }
+
+    weekdays &= ALARM_QUEUE_EVERY_DAY;
+
+    if (!weekdays)
+        return true;
+
+    if (queue->count >= ALARM_QUEUE_SIZE)
+        return false;
+
+    struct alarm_queue_entry entry =
+    {
+        .minute_of_day = hours * 60U + minutes,
+        .weekdays = weekdays,
+        .id = id,
+    };
+
+    entry.next = next_occurrence(&entry, now);
+
+    insert(queue, &entry);
+
+    return true;
+}
+
+void alarm_queue_reschedule(struct alarm_queue *queue, uint32_t now)
+{
+    uint8_t count = queue->count;
+
+    queue->count = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        struct alarm_queue_entry entry = queue->entries[i];
+
+        entry.next = next_occurrence(&entry, now);
+
+        /* Entries before i are already moved, insertion does not overwrite entries not yet processed */
+        insert(queue, &entry);
+    }
+}
+
+bool alarm_queue_poll(struct alarm_queue *queue, uint32_t now, uint8_t *id)
+{
+    if (!queue->count || now < queue->entries[0].next)
+        return false;
+
+    struct alarm_queue_entry entry = queue->entries[0];
+
+    remove_at(queue, 0);
+
+    /* Fired once even if more occurrences passed (time jump), next one is after now */
+    entry.next = next_occurrence(&entry, now);
+
+    insert(queue, &entry);
+
+    *id = entry.id;
+
+    return true;
+}
+
+const struct alarm_queue_entry *alarm_queue_peek(const struct alarm_queue *queue)
+{
+    return queue->count ? &queue->entries[0] : NULL;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+#ifndef ALARM_QUEUE_H_
+#define ALARM_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+/* Entries are kept sorted by next firing time, so per-second check is a single compare against the head
+   and rescheduling (once per firing or alarm change) is an insertion into short sorted array */
+
+#ifndef ALARM_QUEUE_SIZE
+#define ALARM_QUEUE_SIZE 5
+#endif
+
+#define ALARM_QUEUE_EVERY_DAY 0x7F  /* Weekday mask - bit 0 Monday ... bit 6 Sunday */
+
+//------------------------------------------------------------------------------
+
+struct alarm_queue_entry
+{
+    uint32_t next;              /* Next firing time [s since 2000-01-01, local time] */
+    uint16_t minute_of_day;
+    uint8_t weekdays;
+    uint8_t id;
+};
+
+struct alarm_queue
+{
+    struct alarm_queue_entry entries[ALARM_QUEUE_SIZE];
+    uint8_t count;
+};
+
+//------------------------------------------------------------------------------
+
+/// @brief Initializes empty alarm queue
+/// @param queue alarm queue pointer @ref struct alarm_queue
+void alarm_queue_init(struct alarm_queue *queue);
+
+/// @brief Adds, changes or removes alarm
+/// @note Alarm is scheduled to the first matching minute after now, alarm with the same id is replaced
+/// @param queue alarm queue pointer @ref struct alarm_queue
+/// @param id alarm identifier returned by @ref alarm_queue_poll
+/// @param hours alarm hours (0-23)
+/// @param minutes alarm minutes (0-59)
+/// @param weekdays weekday mask (bit 0 Monday ... bit 6 Sunday), 0 removes alarm
+/// @param now current time [s since 2000-01-01]
+/// @return true if alarm was set or removed, false for invalid time or full queue
+bool alarm_queue_set(struct alarm_queue *queue, uint8_t id, uint8_t hours, uint8_t minutes, uint8_t weekdays, uint32_t now);
+
+/// @brief Reschedules all alarms after time discontinuity
+/// @note Has to be called when time is set to arbitrary value, alarms passed in small forward steps
+///       (synchronization, DST) are caught up by @ref alarm_queue_poll and not rescheduled
+/// @param queue alarm queue pointer @ref struct alarm_queue
+/// @param now current time [s since 2000-01-01]
+void alarm_queue_reschedule(struct alarm_queue *queue, uint32_t now);
+
+/// @brief Checks if the earliest alarm is due and reschedules it
+/// @note Alarm missed by skipped seconds fires once on the next call, time moved back does not fire alarm again,
+///       call in loop until false to get all due alarms
+/// @param queue alarm queue pointer @ref struct alarm_queue
+/// @param now current time [s since 2000-01-01]
+/// @param id output identifier of fired alarm
+/// @return true if alarm fired, otherwise false
+bool alarm_queue_poll(struct alarm_queue *queue, uint32_t now, uint8_t *id);
+
+/// @brief Gets the earliest alarm
+/// @param queue alarm queue pointer @ref struct alarm_queue
+/// @return earliest alarm entry pointer @ref struct alarm_queue_entry or NULL if queue is empty
+const struct alarm_queue_entry *alarm_queue_peek(const struct alarm_queue *queue);
+
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ALARM_QUEUE_H_ */
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#include "civil_time.h"
+
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+
+/* Days are counted internally from 1999-03-01, so leap day is the last day of March-based year
+   and month lengths repeat with 153 days per 5 months - no month tables and no carry branches.
+   Every year divisible by 4 is leap in 2000-2099, so 4-year cycle of 1461 days is exact. */
+
+#define CIVIL_TIME_DAYS_MAR_1999_TO_JAN_2000 306U
+#define CIVIL_TIME_DAYS_PER_4_YEARS 1461U
+
+//------------------------------------------------------------------------------
+
+uint8_t civil_time_days_in_month(uint8_t month, uint8_t year)
+{
+    if (month == 2)
+        return 28 + !(year & 0x03);
+
+    /* 31 for odd months up to July and even months from August */
+    return 30 + ((month ^ (month >> 3)) & 0x01);
+}
+
+bool civil_time_is_valid(const struct civil_time *time)
+{
+    if (!time)
+        return false;
+
+    return time->seconds < 60 && time->minutes < 60 && time->hours < 24 && time->year < 100 &&
+           time->month >= 1 && time->month <= 12 && time->date >= 1 && time->date <= civil_time_days_in_month(time->month, time->year);
+}
+
+uint16_t civil_time_to_days(const struct civil_time *time)
+{
+    /* March-based year (0 from 1999-03-01) and month (0 for March, January and February are months 10 and 11) */
+    uint8_t jan_feb = time->month <= 2;
+    uint8_t year = time->year + 1 - jan_feb;
+    uint8_t month = time->month + (jan_feb ? 9 : -3);
+
+    uint16_t day_of_year = (153U * month + 2) / 5 + time->date - 1;
+
+    return 365U * year + ((year + 3) >> 2) + day_of_year - CIVIL_TIME_DAYS_MAR_1999_TO_JAN_2000;
+}
+
+void civil_time_from_days(uint16_t days, struct civil_time *time)
+{
+    uint16_t d = days + CIVIL_TIME_DAYS_MAR_1999_TO_JAN_2000;
+
+    uint8_t cycle = d / CIVIL_TIME_DAYS_PER_4_YEARS;
+    uint16_t day_of_cycle = d - cycle * CIVIL_TIME_DAYS_PER_4_YEARS;
+
+    /* First year of cycle has 366 days */
+    uint8_t year_of_cycle = (day_of_cycle - (day_of_cycle != 0)) / 365;
+    uint16_t day_of_year = day_of_cycle - 365U * year_of_cycle - (year_of_cycle != 0);
+
+    uint8_t month = (5 * day_of_year + 2) / 153;
+
+    time->date = day_of_year - (153U * month + 2) / 5 + 1;
+    time->month = month < 10 ? month + 3 : month - 9;
+    time->year = 4 * cycle + year_of_cycle - 1 + (time->month <= 2);
+    time->day = civil_time_weekday(days);
+}
+
+uint8_t civil_time_weekday(uint16_t days)
+{
+    /* 2000-01-01 was Saturday */
+    return (days + 5) % 7 + 1;
+}
+
+uint32_t civil_time_to_epoch(const struct civil_time *time)
+{
+    uint16_t seconds_of_hour = 60U * time->minutes + time->seconds;
+
+    return ((uint32_t)civil_time_to_days(time) * 24 + time->hours) * 3600 + seconds_of_hour;
+}
+
+void civil_time_from_epoch(uint32_t epoch, struct civil_time *time)
+{
+    uint16_t days = epoch / CIVIL_TIME_SECONDS_PER_DAY;
+    uint32_t seconds_of_day = epoch - days * CIVIL_TIME_SECONDS_PER_DAY;
+
+    /* Single 32-bit division, 3600 = 16 * 225 keeps the rest in 16 bits */
+    uint8_t hours = (uint16_t)(seconds_of_day >> 4) / 225;
+    uint16_t seconds_of_hour = seconds_of_day - hours * 3600UL;
+    uint8_t minutes = seconds_of_hour / 60;
+
+    time->hours = hours;
+    time->minutes = minutes;
+    time->seconds = seconds_of_hour - 60 * minutes;
+
+    civil_time_from_days(days, time);
+}
+
+uint32_t civil_time_epoch_add(uint32_t epoch, int32_t seconds)
+{
+    /* Offset within century - |seconds| < 2^31 is always shorter than century */
+    uint32_t delta = (seconds < 0) ? CIVIL_TIME_SECONDS_PER_CENTURY - (0UL - (uint32_t)seconds) : (uint32_t)seconds;
+
+    /* Wraps at most once, without 32-bit overflow */
+    if (delta >= CIVIL_TIME_SECONDS_PER_CENTURY - epoch)
+        return epoch - (CIVIL_TIME_SECONDS_PER_CENTURY - delta);
+
+    return epoch + delta;
+}
+
+void civil_time_add_seconds(struct civil_time *time, int32_t seconds)
+{
+    if (!time)
+        return;
+
+    civil_time_from_epoch(civil_time_epoch_add(civil_time_to_epoch(time), seconds), time);
+}
+
+//------------------------------------------------------------------------------
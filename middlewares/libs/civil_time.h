@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#ifndef CIVIL_TIME_H_
+#define CIVIL_TIME_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+/* Epoch is 2000-01-01 00:00:00, covered range is 2000-2099 (two-digit year of RTC and DCF77) */
+#define CIVIL_TIME_DAYS_PER_CENTURY 36525U
+#define CIVIL_TIME_SECONDS_PER_DAY 86400UL
+#define CIVIL_TIME_SECONDS_PER_CENTURY ((uint32_t)CIVIL_TIME_DAYS_PER_CENTURY * CIVIL_TIME_SECONDS_PER_DAY)
+
+//------------------------------------------------------------------------------
+
+/* Same layout as RTC time structure */
+struct civil_time
+{
+    uint8_t seconds;    /* 0-59 */
+    uint8_t minutes;    /* 0-59 */
+    uint8_t hours;      /* 0-23 */
+    uint8_t day;        /* Weekday 1-7 (Monday = 1, as in DCF77 frame) */
+    uint8_t date;       /* 1-31 */
+    uint8_t month;      /* 1-12 */
+    uint8_t year;       /* 0-99 (2000-2099) */
+};
+
+//------------------------------------------------------------------------------
+
+/// @brief Gets number of days in given month
+/// @param month month (1-12)
+/// @param year year (0-99)
+/// @return number of days in month
+uint8_t civil_time_days_in_month(uint8_t month, uint8_t year);
+
+/// @brief Checks date and time fields range (weekday is not checked)
+/// @param time time structure pointer @ref struct civil_time
+/// @return true if time is valid, otherwise false
+bool civil_time_is_valid(const struct civil_time *time);
+
+/// @brief Converts date to number of days since 2000-01-01
+/// @param time time structure pointer @ref struct civil_time (time of day and weekday are ignored)
+/// @return days since 2000-01-01 (0-36524)
+uint16_t civil_time_to_days(const struct civil_time *time);
+
+/// @brief Converts number of days since 2000-01-01 to date and weekday
+/// @param days days since 2000-01-01 (0-36524)
+/// @param time output time structure pointer @ref struct civil_time (time of day is not changed)
+void civil_time_from_days(uint16_t days, struct civil_time *time);
+
+/// @brief Gets weekday of given day
+/// @param days days since 2000-01-01
+/// @return weekday 1-7 (Monday = 1)
+uint8_t civil_time_weekday(uint16_t days);
+
+/// @brief Converts time to seconds since 2000-01-01 00:00:00
+/// @param time time structure pointer @ref struct civil_time (weekday is ignored)
+/// @return seconds since epoch
+uint32_t civil_time_to_epoch(const struct civil_time *time);
+
+/// @brief Converts seconds since 2000-01-01 00:00:00 to time
+/// @param epoch seconds since epoch (below CIVIL_TIME_SECONDS_PER_CENTURY)
+/// @param time output time structure pointer @ref struct civil_time
+void civil_time_from_epoch(uint32_t epoch, struct civil_time *time);
+
+/// @brief Adds given number of seconds to epoch
+/// @note Result wraps within 2000-2099, like two-digit year does
+/// @param epoch seconds since epoch (below CIVIL_TIME_SECONDS_PER_CENTURY)
+/// @param seconds seconds to add (negative to subtract)
+/// @return seconds since epoch
+uint32_t civil_time_epoch_add(uint32_t epoch, int32_t seconds);
+
+/// @brief Adds given number of seconds to time and updates weekday
+/// @note Result wraps within 2000-2099, like two-digit year does
+/// @param time time structure pointer @ref struct civil_time
+/// @param seconds seconds to add (negative to subtract)
+void civil_time_add_seconds(struct civil_time *time, int32_t seconds);
+
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CIVIL_TIME_H_ */
+
+//------------------------------------------------------------------------------
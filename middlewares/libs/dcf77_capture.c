@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#include "dcf77_capture.h"
+
+//------------------------------------------------------------------------------
+
+#define DCF77_CAPTURE_BUF_MASK (DCF77_CAPTURE_BUF_SIZE - 1)
+
+#if (DCF77_CAPTURE_BUF_SIZE & DCF77_CAPTURE_BUF_MASK) || DCF77_CAPTURE_BUF_SIZE > 128
+#error "DCF77_CAPTURE_BUF_SIZE has to be power of 2 not greater than 128"
+#endif
+
+#define DCF77_CAPTURE_HEADER_LEVEL_POS      7
+#define DCF77_CAPTURE_HEADER_STATUS_POS     4
+#define DCF77_CAPTURE_HEADER_INDEX_POS      2
+#define DCF77_CAPTURE_HEADER_DELTA_HI_POS   0
+
+//------------------------------------------------------------------------------
+
+static uint8_t encode(uint8_t *rec, uint16_t delta_ms, bool level, uint8_t status, uint8_t bit_index, uint8_t prev_bit_index, bool explicit_index)
+{
+    enum dcf77_capture_bit_index_code code = DCF77_CAPTURE_BIT_INDEX_EXPLICIT;
+
+    if (explicit_index)
+        code = DCF77_CAPTURE_BIT_INDEX_EXPLICIT;
+    else if (bit_index == prev_bit_index)
+        code = DCF77_CAPTURE_BIT_INDEX_SAME;
+    else if (bit_index == (uint8_t)(prev_bit_index + 1))
+        code = DCF77_CAPTURE_BIT_INDEX_NEXT;
+    else if (bit_index == 0)
+        code = DCF77_CAPTURE_BIT_INDEX_ZERO;
+
+    bool delta_hi = delta_ms > UINT8_MAX;
+    uint8_t len = 0;
+
+    rec[len++] = (!!level << DCF77_CAPTURE_HEADER_LEVEL_POS) | ((status & 0x07) << DCF77_CAPTURE_HEADER_STATUS_POS) |
+                 (code << DCF77_CAPTURE_HEADER_INDEX_POS) | (delta_hi << DCF77_CAPTURE_HEADER_DELTA_HI_POS);
+    rec[len++] = (uint8_t)delta_ms;
+
+    if (delta_hi)
+        rec[len++] = (uint8_t)(delta_ms >> 8);
+
+    if (code == DCF77_CAPTURE_BIT_INDEX_EXPLICIT)
+        rec[len++] = bit_index;
+
+    return len;
+}
+
+static uint8_t get_free(struct dcf77_capture *capture)
+{
+    return (capture->tail - capture->head - 1) & DCF77_CAPTURE_BUF_MASK;
+}
+
+static void put(struct dcf77_capture *capture, const uint8_t *rec, uint8_t len)
+{
+    uint8_t head = capture->head;
+
+    for (uint8_t i = 0; i < len; i++)
+    {
+        capture->buf[head] = rec[i];
+        head = (head + 1) & DCF77_CAPTURE_BUF_MASK;
+    }
+
+    /* Published after data is written */
+    capture->head = head;
+}
+
+//------------------------------------------------------------------------------
+
+void dcf77_capture_init(struct dcf77_capture *capture)
+{
+    capture->head = 0;
+    capture->tail = 0;
+    capture->prev_bit_index = 0;
+    capture->dropped = 0;
+}
+
+bool dcf77_capture_push(struct dcf77_capture *capture, uint16_t delta_ms, bool level, uint8_t status, uint8_t bit_index)
+{
+    uint8_t marker[DCF77_CAPTURE_RECORD_MAX_SIZE];
+    uint8_t rec[DCF77_CAPTURE_RECORD_MAX_SIZE];
+    uint8_t marker_len = 0;
+
+    /* After overflow bit index is sent explicitly, reader cannot follow relative codes over the gap */
+    if (capture->dropped)
+        marker_len = encode(marker, capture->dropped, false, DCF77_CAPTURE_STATUS_OVERFLOW, 0, 0, true);
+
+    uint8_t rec_len = encode(rec, delta_ms, level, status, bit_index, capture->prev_bit_index, capture->dropped);
+
+    if (get_free(capture) < marker_len + rec_len)
+    {
+        if (capture->dropped < UINT16_MAX)
+            capture->dropped++;
+
+        return false;
+    }
+
+    if (marker_len)
+        put(capture, marker, marker_len);
+
+    put(capture, rec, rec_len);
+
+    capture->prev_bit_index = bit_index;
+    capture->dropped = 0;
+
+    return true;
+}
+
+uint8_t dcf77_capture_read(struct dcf77_capture *capture, uint8_t *data, uint8_t max)
+{
+    uint8_t head = capture->head;
+    uint8_t tail = capture->tail;
+    uint8_t len = 0;
+
+    while (tail != head && len < max)
+    {
+        data[len++] = capture->buf[tail];
+        tail = (tail + 1) & DCF77_CAPTURE_BUF_MASK;
+    }
+
+    capture->tail = tail;
+
+    return len;
+}
+
+uint8_t dcf77_capture_decode(const uint8_t *data, uint16_t len, uint8_t *prev_bit_index, struct dcf77_capture_record *record)
+{
+    if (!len)
+        return 0;
+
+    uint8_t header = data[0];
+    enum dcf77_capture_bit_index_code code = (header >> DCF77_CAPTURE_HEADER_INDEX_POS) & 0x03;
+    bool delta_hi = (header >> DCF77_CAPTURE_HEADER_DELTA_HI_POS) & 0x01;
+    uint8_t size = 2 + delta_hi + (code == DCF77_CAPTURE_BIT_INDEX_EXPLICIT);
+
+    if (len < size)
+        return 0;
+
+    uint8_t i = 1;
+
+    record->level = (header >> DCF77_CAPTURE_HEADER_LEVEL_POS) & 0x01;
+    record->status = (header >> DCF77_CAPTURE_HEADER_STATUS_POS) & 0x07;
+    record->delta_ms = data[i++];
+
+    if (delta_hi)
+        record->delta_ms |= (uint16_t)data[i++] << 8;
+
+    if (code == DCF77_CAPTURE_BIT_INDEX_SAME)
+        record->bit_index = *prev_bit_index;
+    else if (code == DCF77_CAPTURE_BIT_INDEX_NEXT)
+        record->bit_index = *prev_bit_index + 1;
+    else if (code == DCF77_CAPTURE_BIT_INDEX_ZERO)
+        record->bit_index = 0;
+    else
+        record->bit_index = data[i++];
+
+    /* Overflow marker does not change bit index context */
+    if (record->status != DCF77_CAPTURE_STATUS_OVERFLOW)
+        *prev_bit_index = record->bit_index;
+
+    return size;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#ifndef DCF77_CAPTURE_H_
+#define DCF77_CAPTURE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+/* Record: HEADER | DELTA_LO | [DELTA_HI] | [BIT_INDEX]
+   HEADER: [7] level, [6:4] decoder status, [3:2] bit index code, [1] reserved, [0] DELTA_HI present
+   Delta is time since previous edge in ms (hal_dcf_cb argument), bit index is coded relative to previous record */
+
+#ifndef DCF77_CAPTURE_BUF_SIZE
+#define DCF77_CAPTURE_BUF_SIZE          32 /* Power of 2 */
+#endif
+
+#define DCF77_CAPTURE_RECORD_MAX_SIZE   4
+
+/* Status value not produced by decoder - marks dropped records, delta holds number of dropped records */
+#define DCF77_CAPTURE_STATUS_OVERFLOW   7
+
+//------------------------------------------------------------------------------
+
+enum dcf77_capture_bit_index_code
+{
+    DCF77_CAPTURE_BIT_INDEX_SAME,
+    DCF77_CAPTURE_BIT_INDEX_NEXT,
+    DCF77_CAPTURE_BIT_INDEX_ZERO,
+    DCF77_CAPTURE_BIT_INDEX_EXPLICIT,
+};
+
+//------------------------------------------------------------------------------
+
+struct dcf77_capture_record
+{
+    uint16_t delta_ms;
+    bool level;
+    uint8_t status;         /* @ref enum dcf77_decoder_status or DCF77_CAPTURE_STATUS_OVERFLOW */
+    uint8_t bit_index;
+};
+
+struct dcf77_capture
+{
+    uint8_t buf[DCF77_CAPTURE_BUF_SIZE];
+    volatile uint8_t head;  /* Written by producer (ISR) only */
+    volatile uint8_t tail;  /* Written by consumer (main loop) only */
+    uint8_t prev_bit_index;
+    uint16_t dropped;
+};
+
+//------------------------------------------------------------------------------
+
+/// @brief Initializes capture ring buffer
+/// @param capture capture structure pointer
+void dcf77_capture_init(struct dcf77_capture *capture);
+
+/// @brief Encodes pulse record into ring buffer
+/// @note Single producer - can be called from ISR while @ref dcf77_capture_read is called from main loop,
+///       if there is no space record is dropped and overflow marker is stored before next record
+/// @param capture capture structure pointer
+/// @param delta_ms time since previous edge in ms
+/// @param level signal level after the edge
+/// @param status decoder status returned for that pulse
+/// @param bit_index current bit number in frame
+/// @return true if record was stored, false if it was dropped
+bool dcf77_capture_push(struct dcf77_capture *capture, uint16_t delta_ms, bool level, uint8_t status, uint8_t bit_index);
+
+/// @brief Reads encoded records from ring buffer
+/// @note Single consumer, records can be split between reads - output is a byte stream
+/// @param capture capture structure pointer
+/// @param data output buffer pointer
+/// @param max output buffer size
+/// @return number of bytes read
+uint8_t dcf77_capture_read(struct dcf77_capture *capture, uint8_t *data, uint8_t max);
+
+/// @brief Decodes single record from byte stream (host tools and replay)
+/// @param data encoded stream pointer
+/// @param len encoded stream length
+/// @param prev_bit_index bit index of previous record (updated, 0 at stream start)
+/// @param record output record pointer @ref struct dcf77_capture_record
+/// @return number of bytes consumed or 0 if stream ends with incomplete record
+uint8_t dcf77_capture_decode(const uint8_t *data, uint16_t len, uint8_t *prev_bit_index, struct dcf77_capture_record *record);
+
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DCF77_CAPTURE_H_ */
+
+//------------------------------------------------------------------------------
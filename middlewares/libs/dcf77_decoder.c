@@ -23,6 +23,8 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <civil_time.h>
+
 //------------------------------------------------------------------------------
 
 #define DCF77_DECODER_BIT_VAL_0_MIN_TIME_MS 40
@@ -31,6 +33,38 @@
 #define DCF77_DECODER_BIT_VAL_1_MAX_TIME_MS 250
 #define DCF77_DECODER_BIT_VAL_NONE_MIN_TIME_MS 1500
 #define DCF77_DECODER_BIT_VAL_NONE_MAX_TIME_MS 2200
+#define DCF77_DECODER_BREAK_MIN_TIME_MS 700
+#define DCF77_DECODER_BREAK_MAX_TIME_MS 1000
+
+/* Soft classification - any pulse in acceptance window is a bit, 0 / 1 threshold lies between adaptive cluster centres */
+#define DCF77_DECODER_BIT_MIN_TIME_MS 40
+#define DCF77_DECODER_BIT_MAX_TIME_MS 300
+#define DCF77_DECODER_BIT_VAL_0_NOMINAL_MS 100
+#define DCF77_DECODER_BIT_VAL_1_NOMINAL_MS 200
+#define DCF77_DECODER_BIT_OFFSET_MAX_MS 60      /* Receiver filter delay */
+#define DCF77_DECODER_BIT_MIN_SPREAD_MS 50      /* Minimum distance between cluster centres */
+#define DCF77_DECODER_BIT_ADAPT_DIV 8           /* Cluster centre is moved by 1/8 of distance to confident bit */
+
+/* Bit with following break lasts 1 s, bit 58 (59 with leap second) with minute mark lasts 2 s */
+#define DCF77_DECODER_PERIOD_MS 1000
+#define DCF77_DECODER_PERIOD_TOLERANCE_MS 100
+
+#define DCF77_DECODER_FRAME_BITS 59
+#define DCF77_DECODER_LEAP_SECOND_BIT 59    /* Inserted before minute mark, always 0 */
+#define DCF77_DECODER_LEAP_ANNOUNCEMENTS 2   /* Frames announcing leap second before frame length is changed */
+#define DCF77_DECODER_RING_BITS 64           /* Frame buffer size in bits */
+
+/* First bits of even parity groups - minutes, hours and date */
+#define DCF77_DECODER_MINUTES_START_BIT 21
+#define DCF77_DECODER_HOURS_START_BIT 29
+#define DCF77_DECODER_DATE_START_BIT 36
+
+/* Bits before (weather and call bits) do not affect time */
+#define DCF77_DECODER_TIME_INFO_START_BIT 16
+
+/* Quality score is moved by 1/16 of its distance to 100 % (valid segment) or 0 % (invalid segment or glitch) */
+#define DCF77_DECODER_SCORE_MAX (100U << 8)
+#define DCF77_DECODER_SCORE_SHIFT 4
 
 //------------------------------------------------------------------------------
 
@@ -44,14 +78,41 @@ enum dcf77_bit_val
 
 //------------------------------------------------------------------------------
 
-struct dcf77_ctx 
+struct dcf77_state
 {
     bool frame_started;
     uint8_t bit_cnt;
+    uint8_t parity;                 /* Running parity of current group */
+    enum dcf77_decoder_error error;
+    uint16_t bit_ms;                /* Last bit pulse - checked with following break */
+    uint8_t group_erasures;         /* Erased bits in current group - range checks wait for parity bit */
+    uint8_t tail_cnt;               /* Bits received in 1 s rhythm before frame start */
+    uint8_t tail_pos;               /* Next position of these bits in frame buffer used as ring before frame start */
+    int16_t bit_offset_ms[2];       /* Cluster centres of bit 0 and bit 1 relative to nominal width */
+    bool leap_armed;                /* Leap second announced (bit 19) by last received frames */
+    uint8_t leap_announcements;     /* Consecutive received frames announcing leap second in the same hour */
+    uint8_t leap_hour;              /* Hour of the frame with minute 00 which gets leap second */
+};
+
+struct dcf77_ctx 
+{
+    struct dcf77_state state;
+    struct dcf77_state saved;       /* State before last segment - restored when segment turns out to be split by glitch */
+    uint16_t segment_ms;            /* Last segment extended by following glitches */
+    bool segment_is_bit;
+    bool glitch;
+    struct dcf77_decoder_quality quality;
+    uint8_t erased[8];              /* Low confidence bits of current frame */
+    uint8_t repaired[8];            /* Erased bits inverted by repair - first guess stays recoverable */
+    uint8_t frame_erasures;         /* Erased time information bits of last received frame */
     volatile uint8_t frame[2][8];  
 };
 
+#if DCF77_DECODER_USE_THREAD_LOCAL_CTX
+static _Thread_local struct dcf77_ctx ctx; /* Host tools - independent decoder per worker thread */
+#else
 static struct dcf77_ctx ctx;
+#endif
 
 //------------------------------------------------------------------------------
 
@@ -60,6 +121,12 @@ static bool is_in_range(uint16_t ms, uint16_t min, uint16_t max)
     return (ms >= min) && (ms < max);
 }
 
+static void count(uint16_t *counter)
+{
+    if (*counter < UINT16_MAX)
+        (*counter)++;
+}
+
 static enum dcf77_bit_val get_bit_val(uint16_t ms)
 {
     if (is_in_range(ms, DCF77_DECODER_BIT_VAL_0_MIN_TIME_MS, DCF77_DECODER_BIT_VAL_0_MAX_TIME_MS))
@@ -72,108 +139,599 @@ static enum dcf77_bit_val get_bit_val(uint16_t ms)
     return DCF77_BIT_VAL_ERROR;
 }
 
-static uint8_t frame_get_bit(const volatile uint8_t *frame, uint8_t bit)
+static bool bit_get(const volatile uint8_t *bits, uint8_t bit)
 {
-    return (frame[bit / 8] >> (bit % 8)) & 1;
+    return bits[bit / 8] & (1 << (bit % 8));
 }
 
-static uint8_t frame_get_parity(const volatile uint8_t *frame, uint8_t start, uint8_t len)
+static void bit_set(volatile uint8_t *bits, uint8_t bit, bool val)
 {
-    uint8_t p = 0;
+    if (val)
+        bits[bit / 8] |= (1 << (bit % 8));
+    else
+        bits[bit / 8] &= ~(1 << (bit % 8));
+}
+
+static enum dcf77_bit_val classify_bit(uint16_t ms, bool *erased)
+{
+    *erased = false;
+
+    if (!is_in_range(ms, DCF77_DECODER_BIT_MIN_TIME_MS, DCF77_DECODER_BIT_MAX_TIME_MS))
+        return DCF77_BIT_VAL_ERROR;
+
+    int16_t mean[2] =
+    {
+        DCF77_DECODER_BIT_VAL_0_NOMINAL_MS + ctx.state.bit_offset_ms[0],
+        DCF77_DECODER_BIT_VAL_1_NOMINAL_MS + ctx.state.bit_offset_ms[1],
+    };
+
+    uint16_t threshold = (mean[0] + mean[1]) / 2;
+    enum dcf77_bit_val val = ms < threshold ? DCF77_BIT_VAL_0 : DCF77_BIT_VAL_1;
+
+    ctx.quality.threshold_ms = threshold;
+
+#if DCF77_DECODER_ERASURE_CONFIDENCE
+    /* Confidence - distance from threshold relative to distance of cluster centre (100 % at centre and beyond) */
+    uint16_t distance = val ? ms - threshold : threshold - ms;
+    uint16_t confidence = 100U * distance / (uint16_t)(threshold - mean[0]);
+
+    if (confidence < DCF77_DECODER_ERASURE_CONFIDENCE)
+    {
+        *erased = true;
+        count(&ctx.quality.erasures);
+
+        return val;
+    }
+#endif
+
+    /* Only confident bits move their cluster centre, so erasures cannot pull clusters together */
+    int16_t offset = ctx.state.bit_offset_ms[val] + ((int16_t)ms - mean[val]) / DCF77_DECODER_BIT_ADAPT_DIV;
+
+    mean[val] += offset - ctx.state.bit_offset_ms[val];
+
+    if (offset >= -DCF77_DECODER_BIT_OFFSET_MAX_MS && offset <= DCF77_DECODER_BIT_OFFSET_MAX_MS &&
+        mean[1] - mean[0] >= DCF77_DECODER_BIT_MIN_SPREAD_MS)
+        ctx.state.bit_offset_ms[val] = offset;
 
-    for (uint8_t i = 0; i < len; ++i)
-        p ^= frame_get_bit(frame, start + i);
-    
-    return p;
+    return val;
 }
 
-static bool frame_validate(void)
+static bool bit_guess(uint8_t bit)
 {
-    const volatile uint8_t *frame = ctx.frame[1];
+    return bit_get(ctx.frame[0], bit) ^ bit_get(ctx.repaired, bit);
+}
 
-    /* Bit 0: always 0 (frame start) */
-    if (frame_get_bit(frame, 0) != 0)
-        return false;
+/* Sets erased bit - repair of segment decoded again after glitch gives the same result */
+static void repair_bit(uint8_t bit, bool val)
+{
+    bit_set(ctx.repaired, bit, val != bit_guess(bit));
+    bit_set(ctx.frame[0], bit, val);
+}
 
-    /* Bit 15: always 1 (time start) */
-    if (frame_get_bit(frame, 20) != 1)
-        return false;
+static uint8_t bcd(uint8_t tens, uint8_t units)
+{
+    /* Invalid digit gives value out of every field range */
+    return units > 9 ? 0xFF : 10 * tens + units;
+}
 
-    /* Minute parity: bits 21-27 (minutes), bit 28 (parity) */
-    if (frame_get_parity(frame, 21, 8))
-        return false;
+static void quality_update_score(bool valid)
+{
+    /* Rounded up, so score reaches both 0 and 100 % */
+    if (valid)
+        ctx.quality.score += (DCF77_DECODER_SCORE_MAX - ctx.quality.score + (1 << DCF77_DECODER_SCORE_SHIFT) - 1) >> DCF77_DECODER_SCORE_SHIFT;
+    else
+        ctx.quality.score -= (ctx.quality.score + (1 << DCF77_DECODER_SCORE_SHIFT) - 1) >> DCF77_DECODER_SCORE_SHIFT;
+}
 
-    /* Hour parity: bits 29-34 (hours), bit 35 (parity) */
-    if (frame_get_parity(frame, 29, 7))
-        return false;
+/* Pulse width relative to learned cluster centre of given bit value, saturated so long pulse does not wrap */
+static uint16_t bit_shift(uint16_t ms, enum dcf77_bit_val val)
+{
+    int16_t offset = ctx.state.bit_offset_ms[val];
 
-    /* Date parity: bits 36-57 (date), bit 58 (parity) */
-    if (frame_get_parity(frame, 36, 23))
-        return false;
+    if (offset > 0 && ms < (uint16_t)offset)
+        return 0;
+    if (offset < 0 && ms > UINT16_MAX - (uint16_t)-offset)
+        return UINT16_MAX;
 
-    return true;
+    return ms - offset;
 }
 
-//------------------------------------------------------------------------------
+static void quality_record(uint16_t ms, bool is_bit)
+{
+    enum dcf77_decoder_histogram histogram;
+    uint16_t min;
+    uint16_t max;
 
-enum dcf77_decoder_status dcf77_decode(uint16_t ms, bool triggered_on_bit)
+    enum dcf77_bit_val val = get_bit_val(ms);
+
+    /* Bit windows follow cluster centres - constant receiver delay is not out of range */
+    uint16_t bit_0_ms = bit_shift(ms, DCF77_BIT_VAL_0);
+    uint16_t bit_1_ms = bit_shift(ms, DCF77_BIT_VAL_1);
+
+    if (is_bit && get_bit_val(bit_0_ms) == DCF77_BIT_VAL_0)
+    {
+        histogram = DCF77_DECODER_HISTOGRAM_BIT_0;
+        min = DCF77_DECODER_BIT_VAL_0_MIN_TIME_MS;
+        max = DCF77_DECODER_BIT_VAL_0_MAX_TIME_MS;
+        ms = bit_0_ms;
+    }
+    else if (is_bit && get_bit_val(bit_1_ms) == DCF77_BIT_VAL_1)
+    {
+        histogram = DCF77_DECODER_HISTOGRAM_BIT_1;
+        min = DCF77_DECODER_BIT_VAL_1_MIN_TIME_MS;
+        max = DCF77_DECODER_BIT_VAL_1_MAX_TIME_MS;
+        ms = bit_1_ms;
+    }
+    else if (!is_bit && is_in_range(ms, DCF77_DECODER_BREAK_MIN_TIME_MS, DCF77_DECODER_BREAK_MAX_TIME_MS))
+    {
+        histogram = DCF77_DECODER_HISTOGRAM_BREAK;
+        min = DCF77_DECODER_BREAK_MIN_TIME_MS;
+        max = DCF77_DECODER_BREAK_MAX_TIME_MS;
+    }
+    else
+    {
+        /* Minute mark is valid, but has no histogram */
+        bool valid = !is_bit && val == DCF77_BIT_VAL_NONE;
+
+        if (!valid)
+            count(&ctx.quality.out_of_range);
+
+        quality_update_score(valid);
+
+        return;
+    }
+
+    uint8_t *bins = ctx.quality.histogram[histogram];
+    uint8_t bin = (uint16_t)(ms - min) * DCF77_DECODER_HISTOGRAM_BINS / (max - min);
+
+    /* Halving keeps histogram shape and lets it follow antenna changes */
+    if (bins[bin] == UINT8_MAX)
+    {
+        for (uint8_t i = 0; i < DCF77_DECODER_HISTOGRAM_BINS; i++)
+            bins[i] >>= 1;
+    }
+
+    bins[bin]++;
+
+    quality_update_score(true);
+}
+
+/* Checks range of field which ends with given bit */
+static enum dcf77_decoder_error check_range(uint8_t bit)
 {
-    enum dcf77_bit_val val = 0;
+    uint8_t *frame = (uint8_t *)ctx.frame[0];
 
-    if (!ctx.frame_started)
+    switch (bit)
     {
-        if (get_bit_val(ms) == DCF77_BIT_VAL_NONE)
-        {
-            ctx.frame_started = true;
-            
-            return DCF77_DECODER_STATUS_FRAME_STARTED;
-        }
+    case 24:
+        if (DCF77_DECODER_FRAME_GET_MINUTES_UNITS(frame) > 9)
+            return DCF77_DECODER_ERROR_MINUTES;
+        break;
+    case 27:
+        if (bcd(DCF77_DECODER_FRAME_GET_MINUTES_TENS(frame), DCF77_DECODER_FRAME_GET_MINUTES_UNITS(frame)) > 59)
+            return DCF77_DECODER_ERROR_MINUTES;
+        break;
+    case 32:
+        if (DCF77_DECODER_FRAME_GET_HOURS_UNITS(frame) > 9)
+            return DCF77_DECODER_ERROR_HOURS;
+        break;
+    case 34:
+        if (bcd(DCF77_DECODER_FRAME_GET_HOURS_TENS(frame), DCF77_DECODER_FRAME_GET_HOURS_UNITS(frame)) > 23)
+            return DCF77_DECODER_ERROR_HOURS;
+        break;
+    case 39:
+    case 48:
+    case 53:
+        /* Day, month and year units */
+        if (DCF77_GET_BITS(frame, bit - 3, 0x0F) > 9)
+            return DCF77_DECODER_ERROR_DATE;
+        break;
+    case 41:
+    {
+        uint8_t date = bcd(DCF77_DECODER_FRAME_GET_DAY_TENS(frame), DCF77_DECODER_FRAME_GET_DAY_UNITS(frame));
+        if (date < 1 || date > 31)
+            return DCF77_DECODER_ERROR_DATE;
+        break;
+    }
+    case 44:
+        if (DCF77_DECODER_FRAME_GET_WEEKDAY(frame) == 0)
+            return DCF77_DECODER_ERROR_DATE;
+        break;
+    case 49:
+    {
+        uint8_t month = bcd(DCF77_DECODER_FRAME_GET_MONTH_TENS(frame), DCF77_DECODER_FRAME_GET_MONTH_UNITS(frame));
+        if (month < 1 || month > 12)
+            return DCF77_DECODER_ERROR_DATE;
+        break;
+    }
+    case 57:
+    {
+        uint8_t year = bcd(DCF77_DECODER_FRAME_GET_YEAR_TENS(frame), DCF77_DECODER_FRAME_GET_YEAR_UNITS(frame));
+        uint8_t month = bcd(DCF77_DECODER_FRAME_GET_MONTH_TENS(frame), DCF77_DECODER_FRAME_GET_MONTH_UNITS(frame));
+        uint8_t date = bcd(DCF77_DECODER_FRAME_GET_DAY_TENS(frame), DCF77_DECODER_FRAME_GET_DAY_UNITS(frame));
+        if (year > 99 || date > civil_time_days_in_month(month, year))
+            return DCF77_DECODER_ERROR_DATE;
+        break;
+    }
+    default:
+        break;
+    }
 
-        return DCF77_DECODER_STATUS_WAITING;
+    return DCF77_DECODER_ERROR_NONE;
+}
+
+/* Checks parity of group ending with given bit - single erased bit is repaired, then deferred range checks are done */
+static enum dcf77_decoder_error check_group(uint8_t start, uint8_t end, enum dcf77_decoder_parity group, enum dcf77_decoder_error error)
+{
+    if (ctx.state.group_erasures > 1)
+        return error;
+
+    if (!ctx.state.group_erasures)
+    {
+        if (!ctx.state.parity)
+            return DCF77_DECODER_ERROR_NONE;
+
+        count(&ctx.quality.parity_errors[group]);
+
+        return error;
     }
 
-    if (triggered_on_bit) // Bit transmission
+    for (uint8_t bit = start; bit <= end; bit++)
+    {
+        if (bit_get(ctx.erased, bit))
+            repair_bit(bit, bit_guess(bit) ^ ctx.state.parity);
+    }
+
+    for (uint8_t bit = start; bit < end; bit++)
+    {
+        enum dcf77_decoder_error range_error = check_range(bit);
+
+        if (range_error != DCF77_DECODER_ERROR_NONE)
+            return range_error;
+    }
+
+    return DCF77_DECODER_ERROR_NONE;
+}
+
+/* Checks field which ends with given bit - frame is rejected as soon as it cannot be valid */
+static enum dcf77_decoder_error check_bit(uint8_t bit, uint8_t val, bool erased)
+{
+    if (bit == 0 || bit == DCF77_DECODER_MINUTES_START_BIT || bit == DCF77_DECODER_HOURS_START_BIT || bit == DCF77_DECODER_DATE_START_BIT)
     {
-        val = get_bit_val(ms);
+        ctx.state.parity = 0;
+        ctx.state.group_erasures = 0;
+    }
+
+    ctx.state.parity ^= val;
+    ctx.state.group_erasures += erased;
 
-        if (val == DCF77_BIT_VAL_ERROR || val == DCF77_BIT_VAL_NONE)
+    switch (bit)
+    {
+    case 0:
+        return val ? DCF77_DECODER_ERROR_MARKER : DCF77_DECODER_ERROR_NONE;
+    case 18:
+        /* Exactly one of CEST (bit 17) and CET (bit 18) is set - single erased one is repaired by the other */
+        if (bit_get(ctx.erased, 17) != bit_get(ctx.erased, 18))
         {
-            ctx.frame_started = 0;
-            ctx.bit_cnt = 0;
-            return DCF77_DECODER_STATUS_ERROR;
+            uint8_t erased_bit = bit_get(ctx.erased, 17) ? 17 : 18;
+
+            repair_bit(erased_bit, !bit_get(ctx.frame[0], 17 + 18 - erased_bit));
         }
 
-        uint8_t byte_idx = ctx.bit_cnt / 8;
-        uint8_t bit_idx = ctx.bit_cnt % 8;
-    
-        ctx.frame[0][byte_idx] |= (val << bit_idx);
+        /* Both set or both cleared (also when both are erased) - zone is unknown */
+        if (bit_get(ctx.frame[0], 17) == bit_get(ctx.frame[0], 18))
+            return DCF77_DECODER_ERROR_MARKER;
+        break;
+    case 20:
+        return val ? DCF77_DECODER_ERROR_NONE : DCF77_DECODER_ERROR_MARKER;
+    case DCF77_DECODER_LEAP_SECOND_BIT:
+        return val ? DCF77_DECODER_ERROR_MARKER : DCF77_DECODER_ERROR_NONE;
+    case 28:
+        return check_group(DCF77_DECODER_MINUTES_START_BIT, bit, DCF77_DECODER_PARITY_MINUTES, DCF77_DECODER_ERROR_MINUTES);
+    case 35:
+        return check_group(DCF77_DECODER_HOURS_START_BIT, bit, DCF77_DECODER_PARITY_HOURS, DCF77_DECODER_ERROR_HOURS);
+    case 58:
+        return check_group(DCF77_DECODER_DATE_START_BIT, bit, DCF77_DECODER_PARITY_DATE, DCF77_DECODER_ERROR_DATE);
+    default:
+        break;
+    }
+
+    /* Range of digits with erasures is known after parity repair */
+    return ctx.state.group_erasures ? DCF77_DECODER_ERROR_NONE : check_range(bit);
+}
+
+/* Explicit reset of frame buffer and its masks - bits are ORed in */
+static enum dcf77_decoder_status frame_start(void)
+{
+    ctx.state.frame_started = true;
+    ctx.state.bit_cnt = 0;
+    ctx.state.tail_cnt = 0;
+
+    memset((void*)ctx.frame[0], 0x00, sizeof(ctx.frame[0]));
+    memset(ctx.erased, 0x00, sizeof(ctx.erased));
+    memset(ctx.repaired, 0x00, sizeof(ctx.repaired));
+
+    return DCF77_DECODER_STATUS_FRAME_STARTED;
+}
+
+static enum dcf77_decoder_status frame_abort(enum dcf77_decoder_error error)
+{
+    ctx.state.frame_started = false;
+    ctx.state.bit_cnt = 0;
+    ctx.state.tail_cnt = 0;
+    ctx.state.error = error;
+
+    return DCF77_DECODER_STATUS_ERROR;
+}
+
+/* Leap second is announced (bit 19) during the hour before and inserted at the end of the frame with minute 00 -
+   bit 19 of the frame itself is not used, so a single wrong bit does not change frame length */
+static bool is_leap_minute(void)
+{
+    const uint8_t *frame = (const uint8_t *)ctx.frame[0];
+
+    if (DCF77_DECODER_FRAME_GET_MINUTES_UNITS(frame) || DCF77_DECODER_FRAME_GET_MINUTES_TENS(frame))
+        return false;
+
+    uint8_t hours = bcd(DCF77_DECODER_FRAME_GET_HOURS_TENS(frame), DCF77_DECODER_FRAME_GET_HOURS_UNITS(frame));
+
+    return ctx.state.leap_armed && hours == ctx.state.leap_hour;
+}
+
+static enum dcf77_decoder_status frame_complete(void)
+{
+    const uint8_t *frame = (const uint8_t *)ctx.frame[0];
+
+    /* Every field was already checked - only complete frames reach output buffer */
+    memcpy((void*)ctx.frame[1], (const void*)ctx.frame[0], sizeof(ctx.frame[1]));
+
+    ctx.frame_erasures = 0;
+
+    for (uint8_t bit = DCF77_DECODER_TIME_INFO_START_BIT; bit < ctx.state.bit_cnt; bit++)
+        ctx.frame_erasures += bit_get(ctx.erased, bit);
+
+    /* Armed by repeated announcement until the leap frame, every frame without announcement disarms it (receiver may
+       be powered down for hours) - single wrong bit 19 does not make the next minute 00 frame one bit longer */
+    uint8_t leap_hour = (bcd(DCF77_DECODER_FRAME_GET_HOURS_TENS(frame), DCF77_DECODER_FRAME_GET_HOURS_UNITS(frame)) + 1) % 24;
+
+    if (!DCF77_DECODER_FRAME_GET_LEAP_SECOND(frame) || ctx.state.bit_cnt != DCF77_DECODER_FRAME_BITS)
+        ctx.state.leap_announcements = 0;
+    else if (leap_hour != ctx.state.leap_hour)
+        ctx.state.leap_announcements = 1;
+    else if (ctx.state.leap_announcements < DCF77_DECODER_LEAP_ANNOUNCEMENTS)
+        ctx.state.leap_announcements++;
+
+    ctx.state.leap_armed = ctx.state.leap_announcements >= DCF77_DECODER_LEAP_ANNOUNCEMENTS;
+    ctx.state.leap_hour = leap_hour;
+
+    ctx.state.frame_started = false;
+    ctx.state.bit_cnt = 0;
 
-        ctx.bit_cnt++;
+    return DCF77_DECODER_STATUS_SYNCED;
+}
+
+static bool is_period_valid(uint16_t break_ms, uint16_t period_ms)
+{
+    uint16_t period = ctx.state.bit_ms + break_ms;
+
+    return is_in_range(period, period_ms - DCF77_DECODER_PERIOD_TOLERANCE_MS, period_ms + DCF77_DECODER_PERIOD_TOLERANCE_MS + 1);
+}
+
+static enum dcf77_decoder_error frame_put_bit(uint8_t bit, uint8_t val, bool erased)
+{
+    /* Frame start, time start and leap second markers have fixed values */
+    if (erased && (bit == 0 || bit == 20 || bit == DCF77_DECODER_LEAP_SECOND_BIT))
+    {
+        val = (bit == 20);
+        erased = false;
+    }
+
+    ctx.frame[0][bit / 8] |= (val << (bit % 8));
+
+    if (erased)
+        ctx.erased[bit / 8] |= (1 << (bit % 8));
 
-        if (ctx.bit_cnt >= 59 + DCF77_DECODER_FRAME_GET_LEAP_SECOND(ctx.frame[0]))
+    return check_bit(bit, val, erased);
+}
+
+/* Bits received in 1 s rhythm before first minute mark are kept, so frame ending with that minute mark is complete
+   when they cover every time information bit - synchronization does not have to wait for the next full minute */
+static void tail_push(uint16_t ms)
+{
+    bool erased;
+    enum dcf77_bit_val val = classify_bit(ms, &erased);
+
+    if (val == DCF77_BIT_VAL_ERROR)
+    {
+        ctx.state.tail_cnt = 0;
+        return;
+    }
+
+    bit_set(ctx.frame[0], ctx.state.tail_pos, val);
+    bit_set(ctx.erased, ctx.state.tail_pos, erased);
+
+    ctx.state.tail_pos = (ctx.state.tail_pos + 1) % DCF77_DECODER_RING_BITS;
+
+    if (ctx.state.tail_cnt < DCF77_DECODER_FRAME_BITS)
+        ctx.state.tail_cnt++;
+}
+
+static bool tail_complete(void)
+{
+    /* Frame after leap second announcement may be one bit longer */
+    if (ctx.state.tail_cnt < DCF77_DECODER_FRAME_BITS - DCF77_DECODER_TIME_INFO_START_BIT || ctx.state.leap_armed)
+        return false;
+
+    uint8_t bits[sizeof(ctx.frame[0])] = {0};
+    uint8_t erased[sizeof(ctx.erased)] = {0};
+
+    /* Last bit in ring is bit 58 */
+    for (uint8_t bit = DCF77_DECODER_TIME_INFO_START_BIT; bit < DCF77_DECODER_FRAME_BITS; bit++)
+    {
+        uint8_t pos = (ctx.state.tail_pos + DCF77_DECODER_RING_BITS - DCF77_DECODER_FRAME_BITS + bit) % DCF77_DECODER_RING_BITS;
+
+        bit_set(bits, bit, bit_get(ctx.frame[0], pos));
+        bit_set(erased, bit, bit_get(ctx.erased, pos));
+    }
+
+    memset((void*)ctx.frame[0], 0x00, sizeof(ctx.frame[0]));
+    memset(ctx.erased, 0x00, sizeof(ctx.erased));
+    memset(ctx.repaired, 0x00, sizeof(ctx.repaired));
+
+    /* Bits 16-20 form one group with bits before them */
+    ctx.state.parity = 0;
+    ctx.state.group_erasures = 0;
+
+    for (uint8_t bit = DCF77_DECODER_TIME_INFO_START_BIT; bit < DCF77_DECODER_FRAME_BITS; bit++)
+    {
+        if (frame_put_bit(bit, bit_get(bits, bit), bit_get(erased, bit)) != DCF77_DECODER_ERROR_NONE)
+            return false;
+    }
+
+    ctx.state.bit_cnt = DCF77_DECODER_FRAME_BITS;
+
+    frame_complete();
+
+    return true;
+}
+
+static enum dcf77_decoder_status decode_segment(uint16_t ms, bool triggered_on_bit)
+{
+    if (!ctx.state.frame_started)
+    {
+        if (triggered_on_bit)
         {
-            memcpy((void*)ctx.frame[1], (const void*)ctx.frame[0], sizeof(ctx.frame[1]));
+            ctx.state.bit_ms = ms;
 
-            ctx.frame_started = false;
-            ctx.bit_cnt = 0;
+            tail_push(ms);
+        }
+        else if (get_bit_val(ms) == DCF77_BIT_VAL_NONE && is_period_valid(ms, 2 * DCF77_DECODER_PERIOD_MS))
+        {
+            bool synced = tail_complete();
 
-            if (!frame_validate())
-                return DCF77_DECODER_STATUS_ERROR;
+            frame_start();
 
-            return DCF77_DECODER_STATUS_SYNCED;
+            /* Frame ending with this minute mark is complete, next one is started as well */
+            return synced ? DCF77_DECODER_STATUS_SYNCED : DCF77_DECODER_STATUS_FRAME_STARTED;
         }
+        else if (!is_period_valid(ms, DCF77_DECODER_PERIOD_MS))
+        {
+            /* 1 s rhythm lost */
+            ctx.state.tail_cnt = 0;
+        }
+
+        return DCF77_DECODER_STATUS_WAITING;
+    }
+
+    if (triggered_on_bit) // Bit transmission
+    {
+        bool erased;
+        enum dcf77_bit_val val = classify_bit(ms, &erased);
+
+        if (val == DCF77_BIT_VAL_ERROR)
+            return frame_abort(DCF77_DECODER_ERROR_PULSE);
+
+        enum dcf77_decoder_error error = frame_put_bit(ctx.state.bit_cnt, val, erased);
+
+        if (error != DCF77_DECODER_ERROR_NONE)
+            return frame_abort(error);
+
+        ctx.state.bit_ms = ms;
+        ctx.state.bit_cnt++;
+
+        if (ctx.state.bit_cnt > DCF77_DECODER_LEAP_SECOND_BIT || (ctx.state.bit_cnt == DCF77_DECODER_FRAME_BITS && !is_leap_minute()))
+            return frame_complete();
 
         return DCF77_DECODER_STATUS_BIT_RECEIVED;
     }
     else // Break transmission
     {
-        // TODO: Add breaks validation
-        // TODO: take into account ignoring short pulses - it affects break time
+        /* Minute mark inside frame (missed pulse or leap second not inserted) - frame is lost, but the next one starts */
+        if (get_bit_val(ms) == DCF77_BIT_VAL_NONE && is_period_valid(ms, 2 * DCF77_DECODER_PERIOD_MS))
+        {
+            ctx.state.error = DCF77_DECODER_ERROR_PULSE;
+
+            return frame_start();
+        }
+
+        if (!is_period_valid(ms, DCF77_DECODER_PERIOD_MS))
+            return frame_abort(DCF77_DECODER_ERROR_PERIOD);
 
         return DCF77_DECODER_STATUS_BREAK_RECEIVED;
     }
 }
 
+//------------------------------------------------------------------------------
+
+enum dcf77_decoder_status dcf77_decode(uint16_t ms, bool triggered_on_bit)
+{
+#if DCF77_DECODER_GLITCH_MAX_MS
+    if (ms < DCF77_DECODER_GLITCH_MAX_MS)
+    {
+        /* Spike in break or dropout in bit - its time is added to interrupted segment */
+        ctx.segment_ms += ms;
+        ctx.glitch = !ctx.glitch;
+
+        count(&ctx.quality.glitches);
+        quality_update_score(false);
+
+        return DCF77_DECODER_STATUS_GLITCH;
+    }
+
+    if (ctx.glitch && triggered_on_bit == ctx.segment_is_bit)
+    {
+        /* Segment continues the one split by glitch - decode it again as a whole */
+        uint8_t bit = ctx.saved.frame_started ? ctx.saved.bit_cnt : ctx.saved.tail_pos;
+
+        ms = (ms > UINT16_MAX - ctx.segment_ms) ? UINT16_MAX : ms + ctx.segment_ms;
+
+        ctx.state = ctx.saved;
+        bit_set(ctx.frame[0], bit, false);
+        bit_set(ctx.erased, bit, false);
+        bit_set(ctx.repaired, bit, false);
+    }
+    else if (ctx.segment_ms)
+    {
+        /* Previous segment cannot be extended anymore */
+        quality_record(ctx.segment_ms, ctx.segment_is_bit);
+    }
+
+    ctx.glitch = false;
+    ctx.saved = ctx.state;
+    ctx.segment_ms = ms;
+    ctx.segment_is_bit = triggered_on_bit;
+#else
+    quality_record(ms, triggered_on_bit);
+#endif
+
+    return decode_segment(ms, triggered_on_bit);
+}
+
+void dcf77_decoder_reset(void)
+{
+    memset(&ctx, 0x00, sizeof(ctx));
+}
+
+uint8_t dcf77_decoder_get_bit_count(void)
+{
+    return ctx.state.bit_cnt;
+}
+
+enum dcf77_decoder_error dcf77_decoder_get_error(void)
+{
+    return ctx.state.error;
+}
+
+const struct dcf77_decoder_quality *dcf77_decoder_get_quality(void)
+{
+    return &ctx.quality;
+}
+
+uint8_t dcf77_decoder_get_frame_erasures(void)
+{
+    return ctx.frame_erasures;
+}
+
 volatile uint8_t *dcf77_get_frame(void)
 {
     return ctx.frame[1];
@@ -32,6 +32,24 @@ extern "C" {
 
 //------------------------------------------------------------------------------
 
+/* Shorter pulses (spikes in break, dropouts in bit) are merged with neighbouring segments, 0 disables filter */
+#ifndef DCF77_DECODER_GLITCH_MAX_MS
+#define DCF77_DECODER_GLITCH_MAX_MS 30
+#endif
+
+/* Bits closer to adaptive 0 / 1 threshold than that percentage of distance to cluster centre are erasures - best guess
+   is repaired by parity (single erasure per group) or by the other DST bit instead of aborting frame, 0 disables erasures */
+#ifndef DCF77_DECODER_ERASURE_CONFIDENCE
+#define DCF77_DECODER_ERASURE_CONFIDENCE 30
+#endif
+
+/* Number of bins of every pulse width histogram */
+#ifndef DCF77_DECODER_HISTOGRAM_BINS
+#define DCF77_DECODER_HISTOGRAM_BINS 8
+#endif
+
+//------------------------------------------------------------------------------
+
 enum dcf77_decoder_status
 {
     DCF77_DECODER_STATUS_WAITING,
@@ -40,6 +58,51 @@ enum dcf77_decoder_status
     DCF77_DECODER_STATUS_BREAK_RECEIVED,
     DCF77_DECODER_STATUS_ERROR,
     DCF77_DECODER_STATUS_SYNCED,
+    DCF77_DECODER_STATUS_GLITCH,    /* Pulse ignored, next segment may replace status of the last one */
+};
+
+/* Reason of last DCF77_DECODER_STATUS_ERROR, fields are checked as soon as their last bit arrives */
+enum dcf77_decoder_error
+{
+    DCF77_DECODER_ERROR_NONE,
+    DCF77_DECODER_ERROR_PULSE,      /* Pulse width out of 40-300 ms or minute mark inside frame */
+    DCF77_DECODER_ERROR_MARKER,     /* Frame start (bit 0) or leap second (bit 59) is not 0, time start (bit 20) is not 1
+                                       or not exactly one of CEST / CET (bits 17-18) is set */
+    DCF77_DECODER_ERROR_MINUTES,    /* Parity (bit 28), BCD range or more than one erasure in group */
+    DCF77_DECODER_ERROR_HOURS,      /* Parity (bit 35), BCD range or more than one erasure in group */
+    DCF77_DECODER_ERROR_DATE,       /* Parity (bit 58), BCD range of date, weekday, month and year or erasures */
+    DCF77_DECODER_ERROR_PERIOD,     /* Bit and following break do not last 1 s */
+    DCF77_DECODER_ERROR_MAX,
+};
+
+/* Pulse width histograms, range is split into DCF77_DECODER_HISTOGRAM_BINS equal bins */
+enum dcf77_decoder_histogram
+{
+    DCF77_DECODER_HISTOGRAM_BIT_0,  /* 40-130 ms (nominal 100 ms), shifted by learned receiver delay */
+    DCF77_DECODER_HISTOGRAM_BIT_1,  /* 140-250 ms (nominal 200 ms), shifted by learned receiver delay */
+    DCF77_DECODER_HISTOGRAM_BREAK,  /* 700-1000 ms (nominal 800 and 900 ms), minute mark excluded */
+    DCF77_DECODER_HISTOGRAM_MAX,
+};
+
+/* Parity groups checked by bits 28, 35 and 58 */
+enum dcf77_decoder_parity
+{
+    DCF77_DECODER_PARITY_MINUTES,
+    DCF77_DECODER_PARITY_HOURS,
+    DCF77_DECODER_PARITY_DATE,
+    DCF77_DECODER_PARITY_MAX,
+};
+
+/* Signal quality metrics - updated with every segment also when no frame is started */
+struct dcf77_decoder_quality
+{
+    uint8_t histogram[DCF77_DECODER_HISTOGRAM_MAX][DCF77_DECODER_HISTOGRAM_BINS];  /* Halved when any bin saturates */
+    uint16_t out_of_range;                              /* Segments out of every histogram and minute mark range */
+    uint16_t glitches;                                  /* Pulses shorter than DCF77_DECODER_GLITCH_MAX_MS */
+    uint16_t parity_errors[DCF77_DECODER_PARITY_MAX];
+    uint16_t score;                                     /* Valid segments share [% * 256], averaged over ~16 last ones */
+    uint16_t erasures;                                  /* Bits with confidence below DCF77_DECODER_ERASURE_CONFIDENCE */
+    uint16_t threshold_ms;                              /* Current 0 / 1 threshold */
 };
 
 //------------------------------------------------------------------------------
@@ -75,11 +138,43 @@ enum dcf77_decoder_status
 //------------------------------------------------------------------------------
 
 /// @brief Decodes given pulse (not re-entrant)
+/// @note Bits received in 1 s rhythm before the first minute mark are kept - when they cover bits 16-58, the minute mark
+///       returns DCF77_DECODER_STATUS_SYNCED for the frame it ends (instead of DCF77_DECODER_STATUS_FRAME_STARTED),
+///       the next frame is started with it as well
+/// @note Pulse shorter than DCF77_DECODER_GLITCH_MAX_MS returns DCF77_DECODER_STATUS_GLITCH, then the segment it split
+///       is decoded again as a whole on the next call, so returned status replaces the one returned before glitch
 /// @param ms time in ms of detected pulse
 /// @param triggered_on_bit true if given pulse is considered as a bit value (not break)
 /// @return current status @ref enum dcf77_decoder_status
 enum dcf77_decoder_status dcf77_decode(uint16_t ms, bool triggered_on_bit);
 
+/// @brief Resets decoder to frame start hunting and clears last received frame
+/// @note Decoder state is global (or thread-local with DCF77_DECODER_USE_THREAD_LOCAL_CTX in host tools),
+///       reset is required before decoding unrelated pulse stream
+void dcf77_decoder_reset(void);
+
+/// @brief Gets number of bits received in current frame
+/// @return number of bits (0 when no frame is started)
+uint8_t dcf77_decoder_get_bit_count(void);
+
+/// @brief Gets reason of last error status
+/// @note Minute mark inside frame sets DCF77_DECODER_ERROR_PULSE, but DCF77_DECODER_STATUS_FRAME_STARTED is returned,
+///       because the next frame starts with it
+/// @return last error @ref enum dcf77_decoder_error (DCF77_DECODER_ERROR_NONE after reset)
+enum dcf77_decoder_error dcf77_decoder_get_error(void);
+
+/// @brief Gets signal quality metrics
+/// @note Metrics are updated by @ref dcf77_decode, so they have to be read atomically when decoder is called from ISR,
+///       segment is accounted when the next one arrives (it may still be extended by glitch filter before)
+/// @return metrics pointer @ref struct dcf77_decoder_quality (cleared by @ref dcf77_decoder_reset)
+const struct dcf77_decoder_quality *dcf77_decoder_get_quality(void);
+
+/// @brief Gets number of erased time information bits (16-58) in last received frame
+/// @note Erasures in parity groups and DST bits are repaired, announcement and leap second bits are best guesses,
+///       weather and call bits are not counted
+/// @return number of erased bits
+uint8_t dcf77_decoder_get_frame_erasures(void);
+
 /// @brief Returns pointer do last received time frame
 /// @return last received frame pointer
 volatile uint8_t *dcf77_get_frame(void);
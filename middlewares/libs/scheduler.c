@@ -0,0 +1,167 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#include "scheduler.h"
+
+#include <stddef.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+
+#if SCHEDULER_MAX_TASKS > 8
+#error "Dispatched tasks mask is 8-bit wide"
+#endif
+
+//------------------------------------------------------------------------------
+
+struct scheduler_ctx
+{
+    const struct scheduler_task *tasks;
+    uint8_t tasks_count;
+
+    scheduler_get_time_cb get_time;
+    scheduler_hook_cb task_begin;
+    scheduler_hook_cb task_end;
+
+    uint16_t release_ms[SCHEDULER_MAX_TASKS];
+    struct scheduler_task_stats stats[SCHEDULER_MAX_TASKS];
+};
+
+static struct scheduler_ctx ctx;
+
+//------------------------------------------------------------------------------
+
+static bool is_released(uint8_t task_id, uint16_t now)
+{
+    /* Wrap-safe comparison of 16-bit millisecond tickstamps */
+    return (int16_t)(now - ctx.release_ms[task_id]) >= 0;
+}
+
+static void run_task(uint8_t task_id, uint16_t now)
+{
+    const struct scheduler_task *task = &ctx.tasks[task_id];
+    struct scheduler_task_stats *stats = &ctx.stats[task_id];
+
+    uint16_t latency = now - ctx.release_ms[task_id];
+
+    if (latency > stats->max_latency_ms)
+        stats->max_latency_ms = latency;
+
+    if (task->period_ms)
+    {
+        if (latency >= task->period_ms)
+            stats->deadline_misses++;
+
+        /* Keep release grid, skip releases which were already missed */
+        ctx.release_ms[task_id] += task->period_ms;
+
+        if (is_released(task_id, now))
+            ctx.release_ms[task_id] = now + task->period_ms;
+    }
+    else
+        ctx.release_ms[task_id] = now;
+
+    if (ctx.task_begin)
+        ctx.task_begin(task_id);
+
+    task->task();
+
+    if (ctx.task_end)
+        ctx.task_end(task_id);
+
+    uint16_t exec = ctx.get_time() - now;
+
+    if (exec > stats->max_exec_ms)
+        stats->max_exec_ms = exec;
+
+    if (task->budget_ms && exec > task->budget_ms)
+        stats->overruns++;
+}
+
+//------------------------------------------------------------------------------
+
+bool scheduler_init(const struct scheduler_cfg *cfg)
+{
+    if (!cfg || !cfg->tasks || !cfg->get_time || cfg->tasks_count == 0 || cfg->tasks_count > SCHEDULER_MAX_TASKS)
+        return false;
+
+    for (uint8_t i = 0; i < cfg->tasks_count; i++)
+    {
+        if (!cfg->tasks[i].task)
+            return false;
+    }
+
+    ctx.tasks = cfg->tasks;
+    ctx.tasks_count = cfg->tasks_count;
+    ctx.get_time = cfg->get_time;
+    ctx.task_begin = cfg->task_begin;
+    ctx.task_end = cfg->task_end;
+
+    memset(ctx.stats, 0x00, sizeof(ctx.stats));
+
+    /* Release all tasks immediately */
+    uint16_t now = ctx.get_time();
+
+    for (uint8_t i = 0; i < ctx.tasks_count; i++)
+        ctx.release_ms[i] = now;
+
+    return true;
+}
+
+void scheduler_process(void)
+{
+    uint8_t dispatched = 0; /* Bitmask of tasks already run in this pass */
+
+    if (!ctx.tasks)
+        return;
+
+    while (1)
+    {
+        uint16_t now = ctx.get_time();
+        uint8_t selected = ctx.tasks_count;
+
+        /* Select released task with the highest priority - re-evaluated after each run */
+        for (uint8_t i = 0; i < ctx.tasks_count; i++)
+        {
+            if ((dispatched & (1 << i)) || !is_released(i, now))
+                continue;
+
+            if (selected == ctx.tasks_count || ctx.tasks[i].priority > ctx.tasks[selected].priority)
+                selected = i;
+        }
+
+        if (selected == ctx.tasks_count)
+            return;
+
+        dispatched |= (1 << selected);
+
+        run_task(selected, now);
+    }
+}
+
+const struct scheduler_task_stats *scheduler_get_stats(uint8_t task_id)
+{
+    if (task_id >= ctx.tasks_count)
+        return NULL;
+
+    return &ctx.stats[task_id];
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+#ifndef SCHEDULER_MAX_TASKS
+#define SCHEDULER_MAX_TASKS 6
+#endif
+
+//------------------------------------------------------------------------------
+
+typedef void (*scheduler_task_cb)(void);
+typedef uint16_t (*scheduler_get_time_cb)(void);
+typedef void (*scheduler_hook_cb)(uint8_t task_id);
+
+//------------------------------------------------------------------------------
+
+struct scheduler_task
+{
+    scheduler_task_cb task;
+    uint16_t period_ms;         /* 0 - task is released on every scheduler pass */
+    uint16_t budget_ms;         /* Worst-case execution time, 0 - not monitored */
+    uint8_t priority;           /* Higher value is dispatched first */
+};
+
+struct scheduler_task_stats
+{
+    uint16_t max_exec_ms;
+    uint16_t max_latency_ms;
+    uint16_t overruns;          /* Execution time exceeded budget */
+    uint16_t deadline_misses;   /* Task started later than one period after release */
+};
+
+struct scheduler_cfg
+{
+    const struct scheduler_task *tasks;
+    uint8_t tasks_count;
+
+    scheduler_get_time_cb get_time;
+    scheduler_hook_cb task_begin;
+    scheduler_hook_cb task_end;
+};
+
+//------------------------------------------------------------------------------
+
+/// @brief Initializes scheduler with given static task table
+/// @note Task table has to remain valid during scheduler lifetime, task id is an index in the table
+/// @param cfg configuration structure pointer @ref struct scheduler_cfg
+/// @return true if initialized successfully, otherwise false
+bool scheduler_init(const struct scheduler_cfg *cfg);
+
+/// @brief Dispatches all released tasks in priority order (run-to-completion)
+/// @note Each task is run at most once per call, so the function returns when there is nothing left to do
+void scheduler_process(void);
+
+/// @brief Gets execution statistics of selected task
+/// @param task_id task index in task table
+/// @return pointer to task statistics or NULL if task id is invalid
+const struct scheduler_task_stats *scheduler_get_stats(uint8_t task_id);
+
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCHEDULER_H_ */
+
+//------------------------------------------------------------------------------
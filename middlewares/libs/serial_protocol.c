@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#include "serial_protocol.h"
+
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+
+#define SERIAL_PROTOCOL_CRC8_POLY 0x07
+
+//------------------------------------------------------------------------------
+
+static enum serial_protocol_status parser_error(struct serial_protocol_parser *parser, uint8_t byte)
+{
+    /* Rejected byte can be sync byte of next frame if previous one was truncated */
+    parser->crc = 0;
+    parser->state = (byte == SERIAL_PROTOCOL_SYNC) ? SERIAL_PROTOCOL_PARSER_STATE_LEN : SERIAL_PROTOCOL_PARSER_STATE_SYNC;
+
+    return SERIAL_PROTOCOL_STATUS_ERROR;
+}
+
+//------------------------------------------------------------------------------
+
+uint8_t serial_protocol_crc8(uint8_t crc, uint8_t data)
+{
+    /* Bitwise - 256 B table would cost more flash than the cycles saved at 9600 baud */
+    crc ^= data;
+
+    for (uint8_t i = 0; i < 8; i++)
+        crc = (crc & 0x80) ? (crc << 1) ^ SERIAL_PROTOCOL_CRC8_POLY : (crc << 1);
+
+    return crc;
+}
+
+void serial_protocol_parser_reset(struct serial_protocol_parser *parser)
+{
+    parser->state = SERIAL_PROTOCOL_PARSER_STATE_SYNC;
+}
+
+enum serial_protocol_status serial_protocol_parse(struct serial_protocol_parser *parser, uint8_t byte)
+{
+    switch (parser->state)
+    {
+    case SERIAL_PROTOCOL_PARSER_STATE_SYNC:
+
+        if (byte == SERIAL_PROTOCOL_SYNC)
+        {
+            parser->crc = 0;
+            parser->state = SERIAL_PROTOCOL_PARSER_STATE_LEN;
+        }
+
+        break;
+
+    case SERIAL_PROTOCOL_PARSER_STATE_LEN:
+
+        if (byte > SERIAL_PROTOCOL_MAX_PAYLOAD)
+            return parser_error(parser, byte);
+
+        parser->frame.len = byte;
+        parser->crc = serial_protocol_crc8(parser->crc, byte);
+        parser->state = SERIAL_PROTOCOL_PARSER_STATE_TYPE;
+
+        break;
+
+    case SERIAL_PROTOCOL_PARSER_STATE_TYPE:
+
+        parser->frame.type = byte;
+        parser->crc = serial_protocol_crc8(parser->crc, byte);
+        parser->idx = 0;
+        parser->state = parser->frame.len ? SERIAL_PROTOCOL_PARSER_STATE_PAYLOAD : SERIAL_PROTOCOL_PARSER_STATE_CRC;
+
+        break;
+
+    case SERIAL_PROTOCOL_PARSER_STATE_PAYLOAD:
+
+        parser->frame.payload[parser->idx++] = byte;
+        parser->crc = serial_protocol_crc8(parser->crc, byte);
+
+        if (parser->idx == parser->frame.len)
+            parser->state = SERIAL_PROTOCOL_PARSER_STATE_CRC;
+
+        break;
+
+    case SERIAL_PROTOCOL_PARSER_STATE_CRC:
+
+        if (byte != parser->crc)
+            return parser_error(parser, byte);
+
+        parser->state = SERIAL_PROTOCOL_PARSER_STATE_SYNC;
+
+        return SERIAL_PROTOCOL_STATUS_FRAME_RECEIVED;
+
+    default:
+
+        parser->state = SERIAL_PROTOCOL_PARSER_STATE_SYNC;
+
+        break;
+    }
+
+    return SERIAL_PROTOCOL_STATUS_IN_PROGRESS;
+}
+
+uint8_t serial_protocol_encode(uint8_t type, const void *payload, uint8_t len, uint8_t *buf)
+{
+    if (len > SERIAL_PROTOCOL_MAX_PAYLOAD || (len && !payload) || !buf)
+        return 0;
+
+    const uint8_t *data = payload;
+    uint8_t i = 0;
+    uint8_t crc = 0;
+
+    buf[i++] = SERIAL_PROTOCOL_SYNC;
+
+    buf[i++] = len;
+    crc = serial_protocol_crc8(crc, len);
+
+    buf[i++] = type;
+    crc = serial_protocol_crc8(crc, type);
+
+    for (uint8_t j = 0; j < len; j++)
+    {
+        buf[i++] = data[j];
+        crc = serial_protocol_crc8(crc, data[j]);
+    }
+
+    buf[i++] = crc;
+
+    return i;
+}
+
+//------------------------------------------------------------------------------
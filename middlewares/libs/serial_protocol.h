@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#ifndef SERIAL_PROTOCOL_H_
+#define SERIAL_PROTOCOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+/* Frame: SYNC | LEN | TYPE | PAYLOAD[LEN] | CRC-8 (poly 0x07, init 0x00, over LEN, TYPE and PAYLOAD) */
+
+#define SERIAL_PROTOCOL_SYNC                0xA5
+
+#ifndef SERIAL_PROTOCOL_MAX_PAYLOAD
+#define SERIAL_PROTOCOL_MAX_PAYLOAD         16
+#endif
+
+#define SERIAL_PROTOCOL_OVERHEAD            4
+#define SERIAL_PROTOCOL_MAX_FRAME_SIZE      (SERIAL_PROTOCOL_MAX_PAYLOAD + SERIAL_PROTOCOL_OVERHEAD)
+
+//------------------------------------------------------------------------------
+
+enum serial_protocol_type
+{
+    /* Commands (host to device), response type is command type | SERIAL_PROTOCOL_TYPE_RESPONSE */
+    SERIAL_PROTOCOL_TYPE_GET_TIME = 0x01,
+    SERIAL_PROTOCOL_TYPE_SET_TIME = 0x02,
+    SERIAL_PROTOCOL_TYPE_GET_ALARM = 0x03,
+    SERIAL_PROTOCOL_TYPE_SET_ALARM = 0x04,
+    SERIAL_PROTOCOL_TYPE_GET_TIMEZONE = 0x05,
+    SERIAL_PROTOCOL_TYPE_SET_TIMEZONE = 0x06,
+    SERIAL_PROTOCOL_TYPE_SYNC = 0x07,
+    SERIAL_PROTOCOL_TYPE_GET_DECODER_STATS = 0x08,
+    SERIAL_PROTOCOL_TYPE_SET_DIAG_STREAM = 0x09,
+    SERIAL_PROTOCOL_TYPE_GET_PROFILING = 0x0A,
+    SERIAL_PROTOCOL_TYPE_RESET_PROFILING = 0x0B,
+    SERIAL_PROTOCOL_TYPE_GET_RAM_USAGE = 0x0C,
+    SERIAL_PROTOCOL_TYPE_SET_CAPTURE = 0x0D,
+    SERIAL_PROTOCOL_TYPE_SET_BAUDRATE = 0x0E,
+    SERIAL_PROTOCOL_TYPE_GET_FAULT_JOURNAL = 0x0F,
+    SERIAL_PROTOCOL_TYPE_GET_DECODER_ERRORS = 0x10,
+    SERIAL_PROTOCOL_TYPE_GET_SIGNAL_QUALITY = 0x11,
+    SERIAL_PROTOCOL_TYPE_GET_TASK_STATS = 0x12,
+
+    /* Notifications (device to host) */
+    SERIAL_PROTOCOL_TYPE_TIME_INFO = 0x40,
+    SERIAL_PROTOCOL_TYPE_DIAG = 0x41,
+    SERIAL_PROTOCOL_TYPE_CAPTURE = 0x42,
+    SERIAL_PROTOCOL_TYPE_NACK = 0x7F,
+
+    SERIAL_PROTOCOL_TYPE_RESPONSE = 0x80,
+};
+
+enum serial_protocol_nack_reason
+{
+    SERIAL_PROTOCOL_NACK_UNKNOWN_TYPE = 1,
+    SERIAL_PROTOCOL_NACK_INVALID_LENGTH = 2,
+    SERIAL_PROTOCOL_NACK_INVALID_VALUE = 3,
+};
+
+enum serial_protocol_status
+{
+    SERIAL_PROTOCOL_STATUS_IN_PROGRESS,
+    SERIAL_PROTOCOL_STATUS_FRAME_RECEIVED,
+    SERIAL_PROTOCOL_STATUS_ERROR,
+};
+
+enum serial_protocol_parser_state
+{
+    SERIAL_PROTOCOL_PARSER_STATE_SYNC,
+    SERIAL_PROTOCOL_PARSER_STATE_LEN,
+    SERIAL_PROTOCOL_PARSER_STATE_TYPE,
+    SERIAL_PROTOCOL_PARSER_STATE_PAYLOAD,
+    SERIAL_PROTOCOL_PARSER_STATE_CRC,
+};
+
+//------------------------------------------------------------------------------
+
+struct serial_protocol_frame
+{
+    uint8_t type;
+    uint8_t len;
+    uint8_t payload[SERIAL_PROTOCOL_MAX_PAYLOAD];
+};
+
+struct serial_protocol_nack
+{
+    uint8_t type;       /* Rejected command type */
+    uint8_t reason;     /* @ref enum serial_protocol_nack_reason */
+};
+
+struct serial_protocol_parser
+{
+    enum serial_protocol_parser_state state;
+    uint8_t crc;
+    uint8_t idx;
+    struct serial_protocol_frame frame;
+};
+
+//------------------------------------------------------------------------------
+
+/// @brief Updates CRC-8 (poly 0x07) with single byte
+/// @param crc current CRC value (0x00 for first byte)
+/// @param data next byte
+/// @return updated CRC value
+uint8_t serial_protocol_crc8(uint8_t crc, uint8_t data);
+
+/// @brief Resets parser to sync byte hunting
+/// @param parser parser structure pointer
+void serial_protocol_parser_reset(struct serial_protocol_parser *parser);
+
+/// @brief Feeds parser with single received byte
+/// @note Bytes can be fed from RX interrupt, after error or lost byte parser hunts for next sync byte,
+///       received frame is valid in parser->frame until next call
+/// @param parser parser structure pointer
+/// @param byte received byte
+/// @return SERIAL_PROTOCOL_STATUS_FRAME_RECEIVED when complete frame with valid CRC was received,
+///         SERIAL_PROTOCOL_STATUS_ERROR on CRC or length error, otherwise SERIAL_PROTOCOL_STATUS_IN_PROGRESS
+enum serial_protocol_status serial_protocol_parse(struct serial_protocol_parser *parser, uint8_t byte);
+
+/// @brief Encodes frame into given buffer
+/// @param type frame type @ref enum serial_protocol_type
+/// @param payload payload pointer (can be NULL if len is 0)
+/// @param len payload length (up to SERIAL_PROTOCOL_MAX_PAYLOAD)
+/// @param buf output buffer of at least len + SERIAL_PROTOCOL_OVERHEAD bytes
+/// @return encoded frame size or 0 if payload is too long
+uint8_t serial_protocol_encode(uint8_t type, const void *payload, uint8_t len, uint8_t *buf);
+
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SERIAL_PROTOCOL_H_ */
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,245 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+/* Host check of civil_time.c - exhaustive 2000-2099 round trip against a naive calendar walk and benchmark.
+   Usage: civil_time_check [--full] (--full checks every second of the century instead of every day) */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <civil_time.h>
+
+//------------------------------------------------------------------------------
+
+#define BENCH_ITERATIONS 20000000UL
+
+static unsigned errors;
+
+//------------------------------------------------------------------------------
+
+static bool ref_is_leap(unsigned year)
+{
+    return (year % 4 == 0) && ((year % 100 != 0) || (year % 400 == 0));
+}
+
+static unsigned ref_days_in_month(unsigned month, unsigned year)
+{
+    static const uint8_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    return (month == 2 && ref_is_leap(year)) ? 29 : days[month - 1];
+}
+
+static void report(const char *what, uint32_t value, const struct civil_time *expected, const struct civil_time *actual)
+{
+    if (++errors > 10)
+        return;
+
+    fprintf(stderr, "%s mismatch at %lu: expected %04u-%02u-%02u %02u:%02u:%02u wd %u, got %04u-%02u-%02u %02u:%02u:%02u wd %u\n",
+            what, (unsigned long)value,
+            2000 + expected->year, expected->month, expected->date, expected->hours, expected->minutes, expected->seconds, expected->day,
+            2000 + actual->year, actual->month, actual->date, actual->hours, actual->minutes, actual->seconds, actual->day);
+}
+
+static bool same(const struct civil_time *a, const struct civil_time *b)
+{
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//------------------------------------------------------------------------------
+
+/* Walks the calendar day by day (weekday counted from 2000-01-01 Saturday) */
+static void check_days(void)
+{
+    struct civil_time ref = {.date = 1, .month = 1, .year = 0, .day = 6};
+
+    for (uint32_t days = 0; days < CIVIL_TIME_DAYS_PER_CENTURY; days++)
+    {
+        struct civil_time t = {0};
+
+        civil_time_from_days(days, &t);
+
+        if (!same(&t, &ref))
+            report("from_days", days, &ref, &t);
+
+        if (civil_time_to_days(&ref) != days)
+            report("to_days", days, &ref, &t);
+
+        if (civil_time_days_in_month(ref.month, ref.year) != ref_days_in_month(ref.month, 2000 + ref.year) || !civil_time_is_valid(&ref))
+            report("days_in_month", days, &ref, &t);
+
+        ref.day = ref.day % 7 + 1;
+
+        if (++ref.date > ref_days_in_month(ref.month, 2000 + ref.year))
+        {
+            ref.date = 1;
+
+            if (++ref.month > 12)
+            {
+                ref.month = 1;
+                ref.year++;
+            }
+        }
+    }
+
+    /* Out of range fields */
+    struct civil_time invalid[] =
+    {
+        {.date = 29, .month = 2, .year = 1},
+        {.date = 31, .month = 4, .year = 0},
+        {.date = 0, .month = 1, .year = 0},
+        {.date = 1, .month = 13, .year = 0},
+        {.date = 1, .month = 1, .year = 100},
+        {.date = 1, .month = 1, .hours = 24},
+    };
+
+    for (unsigned i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+        if (civil_time_is_valid(&invalid[i]))
+            report("is_valid", i, &invalid[i], &invalid[i]);
+    }
+}
+
+static void check_epoch(bool full)
+{
+    uint32_t step = full ? 1 : 997; /* Prime step visits every time of day over the century */
+
+    struct civil_time prev;
+
+    civil_time_from_epoch(0, &prev);
+
+    for (uint64_t epoch = 0; epoch < CIVIL_TIME_SECONDS_PER_CENTURY; epoch += step)
+    {
+        struct civil_time t;
+
+        civil_time_from_epoch((uint32_t)epoch, &t);
+
+        struct civil_time ref;
+
+        civil_time_from_days((uint16_t)(epoch / 86400), &ref);
+        ref.hours = epoch % 86400 / 3600;
+        ref.minutes = epoch % 3600 / 60;
+        ref.seconds = epoch % 60;
+
+        if (!same(&t, &ref))
+            report("from_epoch", (uint32_t)epoch, &ref, &t);
+
+        if (civil_time_to_epoch(&t) != epoch)
+            report("to_epoch", (uint32_t)epoch, &ref, &t);
+    }
+
+    /* Adding seconds wraps within century */
+    static const int32_t offsets[] = {1, -1, 3600, -3600, 14 * 3600, -12 * 3600, 86400, -86400, INT32_MAX, INT32_MIN};
+
+    for (uint64_t epoch = 0; epoch < CIVIL_TIME_SECONDS_PER_CENTURY; epoch += 7919 * step)
+    {
+        for (unsigned i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++)
+        {
+            int64_t expected_epoch = ((int64_t)epoch + offsets[i]) % (int64_t)CIVIL_TIME_SECONDS_PER_CENTURY;
+
+            if (expected_epoch < 0)
+                expected_epoch += CIVIL_TIME_SECONDS_PER_CENTURY;
+
+            struct civil_time t, ref;
+
+            civil_time_from_epoch((uint32_t)epoch, &t);
+            civil_time_from_epoch((uint32_t)expected_epoch, &ref);
+            civil_time_add_seconds(&t, offsets[i]);
+
+            if (!same(&t, &ref))
+                report("add_seconds", (uint32_t)epoch, &ref, &t);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static void benchmark(void)
+{
+    volatile uint32_t sink = 0;
+    struct civil_time t;
+    double start;
+
+    start = now_s();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        civil_time_from_epoch((i * 2654435761UL) % CIVIL_TIME_SECONDS_PER_CENTURY, &t);
+        sink += t.seconds;
+    }
+    printf("civil_time_from_epoch  %6.1f ns/call\n", (now_s() - start) * 1e9 / BENCH_ITERATIONS);
+
+    start = now_s();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        t.year = i % 100;
+        t.month = i % 12 + 1;
+        t.date = i % 28 + 1;
+        t.hours = i % 24;
+        sink += civil_time_to_epoch(&t);
+    }
+    printf("civil_time_to_epoch    %6.1f ns/call\n", (now_s() - start) * 1e9 / BENCH_ITERATIONS);
+
+    start = now_s();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        civil_time_add_seconds(&t, (i & 1) ? 3600 : -3599);
+        sink += t.hours;
+    }
+    printf("civil_time_add_seconds %6.1f ns/call\n", (now_s() - start) * 1e9 / BENCH_ITERATIONS);
+
+    (void)sink;
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    bool full = argc > 1 && strcmp(argv[1], "--full") == 0;
+
+    check_days();
+    check_epoch(full);
+
+    if (errors)
+    {
+        printf("FAILED: %u mismatches\n", errors);
+        return 1;
+    }
+
+    printf("2000-2099 round trip OK (%s)\n", full ? "every second" : "every day, sampled seconds");
+
+    benchmark();
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
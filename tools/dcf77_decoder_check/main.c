@@ -0,0 +1,538 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+/* Host check of dcf77_decoder.c - pulse trains of known frames are replayed through the decoder and decoded frames
+   are compared with the transmitted ones.
+   Usage: dcf77_decoder_check */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <dcf77_decoder.h>
+
+//------------------------------------------------------------------------------
+
+#define FRAME_BITS 59
+#define FRAME_BYTES 8
+
+#define BIT_0_MS 100
+#define BIT_1_MS 200
+#define PERIOD_MS 1000
+
+/* Pulses just across the initial 150 ms threshold - low confidence bits whose first guess is wrong */
+#define ERASED_0_MS 155
+#define ERASED_1_MS 145
+
+/* Dropout close to the end of pulse - pulse is decoded before it and again as a whole after it */
+#define DROPOUT_MS 10
+#define DROPOUT_REST_MS 30
+
+#define DCF77_TIME_INFO_START_BIT 16    /* Bits before do not affect time */
+#define TAIL_CORRUPTED_MS 350           /* Out of every bit window */
+#define TAIL_RHYTHM_LOST_MS 400         /* Bit and break far shorter than 1 s */
+#define TAIL_WRAP_OFFSET 40             /* Bits received before aborted frame - following ones wrap in 64 bit ring */
+
+#define SHIFTED_DELAY_MS 30
+#define SHIFTED_FRAMES 4
+#define SHIFTED_MIN_SCORE (90U << 8)
+#define SHIFTED_THRESHOLD_TOLERANCE_MS 8    /* Cluster centre stops short of pulse width by less than adaptation step */
+#define SHIFTED_BIT_0_BIN 5     /* 100 ms in 40-130 ms */
+#define SHIFTED_BIT_1_BIN 4     /* 200 ms in 140-250 ms */
+
+//------------------------------------------------------------------------------
+
+struct frame_time
+{
+    uint8_t minutes;
+    uint8_t hours;
+    uint8_t date;
+    uint8_t weekday;    /* 1 - Monday */
+    uint8_t month;
+    uint8_t year;
+};
+
+static unsigned errors;
+
+static uint8_t frame[FRAME_BYTES];                  /* Transmitted frame, bit 0 = LSB of frame[0] */
+static uint8_t erased[FRAME_BYTES];                 /* Frame bits sent with ERASED_0_MS / ERASED_1_MS */
+static enum dcf77_decoder_status last_bit_status;   /* Status returned for the last bit of sent frame */
+static bool split_last_bit;                         /* Last bit of sent frame is split by dropout */
+
+//------------------------------------------------------------------------------
+
+static void check(bool ok, const char *what)
+{
+    if (ok)
+        return;
+
+    errors++;
+    fprintf(stderr, "FAILED: %s\n", what);
+}
+
+static void frame_set_bit(uint8_t bit, bool val)
+{
+    if (val)
+        frame[bit / 8] |= 1 << (bit % 8);
+    else
+        frame[bit / 8] &= ~(1 << (bit % 8));
+}
+
+static bool frame_get_bit(uint8_t bit)
+{
+    return frame[bit / 8] & (1 << (bit % 8));
+}
+
+static void frame_set_bcd(uint8_t start, uint8_t units_len, uint8_t tens_len, uint8_t value)
+{
+    for (uint8_t i = 0; i < units_len; i++)
+        frame_set_bit(start + i, (value % 10) & (1 << i));
+
+    for (uint8_t i = 0; i < tens_len; i++)
+        frame_set_bit(start + units_len + i, (value / 10) & (1 << i));
+}
+
+static void frame_set_parity(uint8_t start, uint8_t parity_bit)
+{
+    bool parity = false;
+
+    for (uint8_t bit = start; bit < parity_bit; bit++)
+        parity ^= frame_get_bit(bit);
+
+    frame_set_bit(parity_bit, parity);
+}
+
+/* CET frame of given time, weather and call bits are 0 */
+static void frame_build(const struct frame_time *time)
+{
+    memset(frame, 0x00, sizeof(frame));
+    memset(erased, 0x00, sizeof(erased));
+
+    frame_set_bit(18, true);
+    frame_set_bit(20, true);
+
+    frame_set_bcd(21, 4, 3, time->minutes);
+    frame_set_parity(21, 28);
+    frame_set_bcd(29, 4, 2, time->hours);
+    frame_set_parity(29, 35);
+    frame_set_bcd(36, 4, 2, time->date);
+    frame_set_bcd(42, 3, 0, time->weekday);
+    frame_set_bcd(45, 4, 1, time->month);
+    frame_set_bcd(50, 4, 4, time->year);
+    frame_set_parity(36, 58);
+}
+
+static uint16_t frame_bit_ms(uint8_t bit)
+{
+    if (erased[bit / 8] & (1 << (bit % 8)))
+        return frame_get_bit(bit) ? ERASED_1_MS : ERASED_0_MS;
+
+    return frame_get_bit(bit) ? BIT_1_MS : BIT_0_MS;
+}
+
+/* Sends frame bits from given one up to given number of bits followed by minute mark, every pulse is lengthened by
+   given receiver delay */
+static enum dcf77_decoder_status frame_send_from(uint8_t first, uint8_t bits, int16_t delay_ms)
+{
+    enum dcf77_decoder_status status = DCF77_DECODER_STATUS_WAITING;
+
+    for (uint8_t bit = first; bit < bits; bit++)
+    {
+        uint16_t bit_ms = frame_bit_ms(bit) + delay_ms;
+
+        if (split_last_bit && bit == bits - 1)
+        {
+            dcf77_decode(bit_ms - DROPOUT_MS - DROPOUT_REST_MS, true);
+            dcf77_decode(DROPOUT_MS, false);
+            last_bit_status = dcf77_decode(DROPOUT_REST_MS, true);
+        }
+        else
+        {
+            last_bit_status = dcf77_decode(bit_ms, true);
+        }
+
+        status = dcf77_decode((bit == bits - 1 ? 2 * PERIOD_MS : PERIOD_MS) - bit_ms, false);
+    }
+
+    return status;
+}
+
+static enum dcf77_decoder_status frame_send(uint8_t bits, int16_t delay_ms)
+{
+    return frame_send_from(0, bits, delay_ms);
+}
+
+/* Resets decoder and sends minute mark, so the next sent frame is received from bit 0 */
+static void decoder_start(void)
+{
+    dcf77_decoder_reset();
+
+    dcf77_decode(BIT_0_MS, true);
+    check(dcf77_decode(2 * PERIOD_MS - BIT_0_MS, false) == DCF77_DECODER_STATUS_FRAME_STARTED, "start: minute mark starts frame");
+}
+
+static bool frame_received(void)
+{
+    uint8_t received[FRAME_BYTES];
+
+    memcpy(received, (const void *)dcf77_get_frame(), sizeof(received));
+
+    return memcmp(received, frame, sizeof(received)) == 0;
+}
+
+/* Sends frame bits until the decoder rejects the frame, returns rejected bit (FRAME_BITS when every bit is accepted) */
+static uint8_t frame_send_until_error(void)
+{
+    for (uint8_t bit = 0; bit < FRAME_BITS; bit++)
+    {
+        uint16_t bit_ms = frame_bit_ms(bit);
+
+        if (dcf77_decode(bit_ms, true) == DCF77_DECODER_STATUS_ERROR)
+            return bit;
+
+        dcf77_decode((bit == FRAME_BITS - 1 ? 2 * PERIOD_MS : PERIOD_MS) - bit_ms, false);
+    }
+
+    return FRAME_BITS;
+}
+
+//------------------------------------------------------------------------------
+
+/* Bits are ORed into frame buffer - bits set in the previous frame must not leak into the next one */
+static void check_consecutive_frames(void)
+{
+    struct frame_time time = {.minutes = 37, .hours = 12, .date = 14, .weekday = 5, .month = 3, .year = 25};
+
+    decoder_start();
+
+    for (uint8_t i = 0; i < 3; i++, time.minutes++)
+    {
+        frame_build(&time);
+
+        check(frame_send(FRAME_BITS, 0) == DCF77_DECODER_STATUS_FRAME_STARTED, "consecutive: minute mark starts next frame");
+        check(last_bit_status == DCF77_DECODER_STATUS_SYNCED, "consecutive: frame synced");
+        check(frame_received(), "consecutive: received frame matches transmitted one");
+    }
+}
+
+/* Break split by spike is a period error until the rest of it arrives - decoding it again as a whole repairs the frame,
+   so the error must not be counted before the next segment */
+static void check_split_break(void)
+{
+    struct frame_time time = {.minutes = 5, .hours = 8, .date = 2, .weekday = 3, .month = 7, .year = 25};
+
+    decoder_start();
+    frame_build(&time);
+
+    for (uint8_t bit = 0; bit < FRAME_BITS; bit++)
+    {
+        uint16_t bit_ms = frame_get_bit(bit) ? BIT_1_MS : BIT_0_MS;
+        uint16_t break_ms = (bit == FRAME_BITS - 1 ? 2 * PERIOD_MS : PERIOD_MS) - bit_ms;
+
+        last_bit_status = dcf77_decode(bit_ms, true);
+
+        if (bit == 10)
+        {
+            check(dcf77_decode(300, false) == DCF77_DECODER_STATUS_ERROR, "split break: first part is period error");
+            check(dcf77_decode(8, true) == DCF77_DECODER_STATUS_GLITCH, "split break: spike is glitch");
+            check(dcf77_decode(break_ms - 308, false) == DCF77_DECODER_STATUS_BREAK_RECEIVED, "split break: whole break repairs frame");
+        }
+        else
+        {
+            dcf77_decode(break_ms, false);
+        }
+    }
+
+    check(last_bit_status == DCF77_DECODER_STATUS_SYNCED, "split break: frame synced");
+    check(frame_received(), "split break: received frame matches transmitted one");
+}
+
+/* Receiver lengthening every pulse by its filter delay - frames are decoded and quality windows follow learned delay */
+static void check_shifted_pulses(void)
+{
+    struct frame_time time = {.minutes = 10, .hours = 16, .date = 31, .weekday = 5, .month = 10, .year = 25};
+    const struct dcf77_decoder_quality *quality = dcf77_decoder_get_quality();
+    uint16_t out_of_range = 0;
+
+    decoder_start();
+
+    for (uint8_t i = 0; i < SHIFTED_FRAMES; i++, time.minutes++)
+    {
+        frame_build(&time);
+
+        frame_send(FRAME_BITS, SHIFTED_DELAY_MS);
+
+        check(last_bit_status == DCF77_DECODER_STATUS_SYNCED, "shifted: frame synced");
+        check(frame_received(), "shifted: received frame matches transmitted one");
+
+        /* Cluster centres are learned during the first frame */
+        if (i == 0)
+            out_of_range = quality->out_of_range;
+    }
+
+    check(quality->out_of_range == out_of_range, "shifted: learned pulses are not out of range");
+    check(quality->score >= SHIFTED_MIN_SCORE, "shifted: quality score is high");
+    check(quality->threshold_ms + SHIFTED_THRESHOLD_TOLERANCE_MS >= (BIT_0_MS + BIT_1_MS) / 2 + SHIFTED_DELAY_MS &&
+          quality->threshold_ms <= (BIT_0_MS + BIT_1_MS) / 2 + SHIFTED_DELAY_MS, "shifted: threshold follows delay");
+    check(quality->histogram[DCF77_DECODER_HISTOGRAM_BIT_0][SHIFTED_BIT_0_BIN] &&
+          quality->histogram[DCF77_DECODER_HISTOGRAM_BIT_1][SHIFTED_BIT_1_BIN], "shifted: nominal bins are filled");
+}
+
+/* Sends frame of given time with leap second announcement (bit 19) and given number of bits, returns true when the
+   frame is synced by its last bit and the minute mark starts the next one */
+static void leap_frame_build(uint8_t hours, uint8_t minutes, bool announcement)
+{
+    struct frame_time time = {.minutes = minutes, .hours = hours, .date = 30, .weekday = 2, .month = 6, .year = 26};
+
+    frame_build(&time);
+    frame_set_bit(19, announcement);
+    frame_set_parity(21, 28);
+}
+
+static bool leap_frame_send(uint8_t hours, uint8_t minutes, bool announcement, uint8_t bits)
+{
+    leap_frame_build(hours, minutes, announcement);
+
+    return frame_send(bits, 0) == DCF77_DECODER_STATUS_FRAME_STARTED && last_bit_status == DCF77_DECODER_STATUS_SYNCED &&
+           frame_received();
+}
+
+/* Leap second bit is inserted into the minute 00 frame only after repeated announcement - single wrong bit 19 must
+   not make the decoder wait for the 60th bit */
+static void check_leap_second(void)
+{
+    decoder_start();
+
+    check(leap_frame_send(12, 59, false, FRAME_BITS), "leap: frame before wrong bit 19");
+    check(leap_frame_send(13, 0, true, FRAME_BITS), "leap: wrong bit 19 in minute 00 frame");
+
+    check(leap_frame_send(13, 58, false, FRAME_BITS), "leap: frame before single announcement");
+    check(leap_frame_send(13, 59, true, FRAME_BITS), "leap: single announcement");
+    check(leap_frame_send(14, 0, false, FRAME_BITS), "leap: single announcement does not insert leap second");
+
+    /* Frame completed by the first part of split last bit is completed again by the whole bit - still one announcement */
+    check(leap_frame_send(20, 58, false, FRAME_BITS), "leap: frame before split announcement");
+    split_last_bit = true;
+    check(leap_frame_send(20, 59, true, FRAME_BITS), "leap: announcement with split last bit");
+    split_last_bit = false;
+    check(leap_frame_send(21, 0, false, FRAME_BITS), "leap: split announcement does not insert leap second");
+
+    check(leap_frame_send(22, 58, true, FRAME_BITS), "leap: first announcement");
+    check(leap_frame_send(22, 59, true, FRAME_BITS), "leap: second announcement");
+    check(leap_frame_send(23, 0, true, FRAME_BITS + 1), "leap: leap second inserted");
+    check(leap_frame_send(23, 1, false, FRAME_BITS), "leap: frame after leap second");
+}
+
+/* Sends frame bits from given one up to given bit, each followed by break of 1 s period (no minute mark) */
+static void tail_send(uint8_t first, uint8_t last)
+{
+    for (uint8_t bit = first; bit < last; bit++)
+    {
+        uint16_t bit_ms = frame_bit_ms(bit);
+
+        dcf77_decode(bit_ms, true);
+        dcf77_decode(PERIOD_MS - bit_ms, false);
+    }
+}
+
+/* Corrupted pulse in place of bit 0 - started frame is aborted, decoder collects bits before the next minute mark */
+static void frame_abort_at_start(void)
+{
+    check(dcf77_decode(TAIL_CORRUPTED_MS, true) == DCF77_DECODER_STATUS_ERROR, "tail: corrupted pulse aborts frame");
+    dcf77_decode(PERIOD_MS - TAIL_CORRUPTED_MS, false);
+}
+
+/* Bits 16-58 received before the first minute mark complete the frame already at that minute mark */
+static void check_tail_sync(void)
+{
+    struct frame_time time = {.minutes = 7, .hours = 6, .date = 17, .weekday = 1, .month = 11, .year = 25};
+
+    /* Lock at second 16 - every time information bit is received */
+    dcf77_decoder_reset();
+    frame_build(&time);
+
+    check(frame_send_from(DCF77_TIME_INFO_START_BIT, FRAME_BITS, 0) == DCF77_DECODER_STATUS_SYNCED, "tail: lock at second 16 syncs");
+    check(frame_received(), "tail: frame from bits before minute mark matches transmitted one");
+
+    time.minutes++;
+    frame_build(&time);
+
+    check(frame_send(FRAME_BITS, 0) == DCF77_DECODER_STATUS_FRAME_STARTED && last_bit_status == DCF77_DECODER_STATUS_SYNCED,
+          "tail: minute mark after tail sync starts next frame");
+
+    /* Lock at second 17 - bit 16 is missing */
+    dcf77_decoder_reset();
+
+    check(frame_send_from(DCF77_TIME_INFO_START_BIT + 1, FRAME_BITS, 0) == DCF77_DECODER_STATUS_FRAME_STARTED,
+          "tail: lock after second 16 does not sync");
+
+    /* Break out of 1 s rhythm drops bits received before it */
+    dcf77_decoder_reset();
+    tail_send(5, 30);
+    dcf77_decode(frame_bit_ms(30), true);
+    dcf77_decode(TAIL_RHYTHM_LOST_MS, false);
+
+    check(frame_send_from(31, FRAME_BITS, 0) == DCF77_DECODER_STATUS_FRAME_STARTED, "tail: rhythm loss drops collected bits");
+
+    /* Bits collected after aborted frame wrap around the ring end */
+    dcf77_decoder_reset();
+    frame_send_from(FRAME_BITS - TAIL_WRAP_OFFSET, FRAME_BITS, 0);
+    time.minutes++;
+    frame_build(&time);
+    frame_abort_at_start();
+
+    check(frame_send_from(1, FRAME_BITS, 0) == DCF77_DECODER_STATUS_SYNCED, "tail: bits wrapped in ring sync");
+    check(frame_received(), "tail: frame from wrapped bits matches transmitted one");
+
+    /* Frame expected with leap second is not assembled from bits before its minute mark */
+    decoder_start();
+
+    check(leap_frame_send(22, 58, true, FRAME_BITS) && leap_frame_send(22, 59, true, FRAME_BITS), "tail: leap second armed");
+
+    leap_frame_build(23, 0, true);
+    frame_abort_at_start();
+
+    check(frame_send_from(1, FRAME_BITS + 1, 0) == DCF77_DECODER_STATUS_FRAME_STARTED, "tail: leap frame is not assembled");
+    check(leap_frame_send(23, 1, false, FRAME_BITS), "tail: frame after leap frame synced");
+}
+
+/* Exactly one of CEST (bit 17) and CET (bit 18) is set - frame with both or none gives no time zone */
+static void check_dst_bits(void)
+{
+    struct frame_time time = {.minutes = 30, .hours = 2, .date = 26, .weekday = 7, .month = 10, .year = 25};
+
+    const bool zones[][2] = {{false, false}, {true, true}};
+
+    for (uint8_t i = 0; i < sizeof(zones) / sizeof(zones[0]); i++)
+    {
+        decoder_start();
+        frame_build(&time);
+        frame_set_bit(17, zones[i][0]);
+        frame_set_bit(18, zones[i][1]);
+
+        check(frame_send_until_error() == 18, "DST bits: invalid zone rejected at bit 18");
+        check(dcf77_decoder_get_error() == DCF77_DECODER_ERROR_MARKER, "DST bits: invalid zone is marker error");
+    }
+}
+
+/* Field is checked as soon as its last bit arrives - frame is rejected there with error of the failing field */
+static void check_field_errors(void)
+{
+    struct frame_time time = {.minutes = 45, .hours = 21, .date = 9, .weekday = 4, .month = 1, .year = 25};
+    const struct dcf77_decoder_quality *quality = dcf77_decoder_get_quality();
+
+    decoder_start();
+    frame_build(&time);
+    frame_set_bit(28, !frame_get_bit(28));
+
+    uint16_t parity_errors = quality->parity_errors[DCF77_DECODER_PARITY_MINUTES];
+
+    check(frame_send_until_error() == 28, "fields: minute parity rejected at bit 28");
+    check(dcf77_decoder_get_error() == DCF77_DECODER_ERROR_MINUTES, "fields: minute parity is minutes error");
+    check(quality->parity_errors[DCF77_DECODER_PARITY_MINUTES] == parity_errors + 1, "fields: minute parity error counted");
+
+    /* Minute units digit 10 */
+    decoder_start();
+    frame_build(&time);
+    frame_set_bcd(21, 4, 0, 0);
+    frame_set_bit(22, true);
+    frame_set_bit(24, true);
+
+    check(frame_send_until_error() == 24, "fields: minute digit rejected at bit 24");
+    check(dcf77_decoder_get_error() == DCF77_DECODER_ERROR_MINUTES, "fields: minute digit is minutes error");
+
+    time.hours = 24;
+    decoder_start();
+    frame_build(&time);
+
+    check(frame_send_until_error() == 34, "fields: hour 24 rejected at bit 34");
+    check(dcf77_decoder_get_error() == DCF77_DECODER_ERROR_HOURS, "fields: hour 24 is hours error");
+
+    time.hours = 21;
+    time.month = 13;
+    decoder_start();
+    frame_build(&time);
+
+    check(frame_send_until_error() == 49, "fields: month 13 rejected at bit 49");
+    check(dcf77_decoder_get_error() == DCF77_DECODER_ERROR_DATE, "fields: month 13 is date error");
+}
+
+static void frame_set_erased(uint8_t bit)
+{
+    erased[bit / 8] |= 1 << (bit % 8);
+}
+
+/* Single low confidence bit in parity group is repaired by the parity bit, two of them reject the frame */
+static void check_erasures(void)
+{
+    struct frame_time time = {.minutes = 45, .hours = 21, .date = 9, .weekday = 4, .month = 1, .year = 25};
+
+    decoder_start();
+    frame_build(&time);
+    frame_set_erased(22);
+    frame_set_erased(40);
+
+    check(frame_send(FRAME_BITS, 0) == DCF77_DECODER_STATUS_FRAME_STARTED, "erasures: minute mark starts next frame");
+    check(last_bit_status == DCF77_DECODER_STATUS_SYNCED, "erasures: frame with repaired bits synced");
+    check(frame_received(), "erasures: repaired frame matches transmitted one");
+    check(dcf77_decoder_get_frame_erasures() == 2, "erasures: repaired bits counted");
+
+    time.minutes++;
+    frame_build(&time);
+
+    check(frame_send(FRAME_BITS, 0) == DCF77_DECODER_STATUS_FRAME_STARTED && last_bit_status == DCF77_DECODER_STATUS_SYNCED,
+          "erasures: next frame synced");
+    check(dcf77_decoder_get_frame_erasures() == 0, "erasures: count is per frame");
+
+    decoder_start();
+    frame_build(&time);
+    frame_set_erased(22);
+    frame_set_erased(23);
+
+    check(frame_send_until_error() == 28, "erasures: two erasures in group rejected at parity bit");
+    check(dcf77_decoder_get_error() == DCF77_DECODER_ERROR_MINUTES, "erasures: two erasures in minutes is minutes error");
+}
+
+//------------------------------------------------------------------------------
+
+int main(void)
+{
+    check_consecutive_frames();
+    check_split_break();
+    check_shifted_pulses();
+    check_leap_second();
+    check_tail_sync();
+    check_dst_bits();
+    check_field_errors();
+    check_erasures();
+
+    if (errors)
+    {
+        printf("FAILED: %u checks\n", errors);
+        return 1;
+    }
+
+    printf("DCF77 decoder OK\n");
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
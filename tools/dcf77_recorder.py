@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+
+#-------------------------------------------------------------------------------
+
+# Copyright 2025 Michal Lokcewicz
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#-------------------------------------------------------------------------------
+
+"""DCF77 raw pulse recorder.
+
+Enables capture mode over the serial protocol, collects capture notification
+frames and stores their payload (dcf77_capture record stream) in a file.
+Recordings are replay corpus for decoder regression and threshold tuning.
+
+Recording file: b'DCF77CAP' magic, version byte (1), record stream.
+
+Record (middlewares/libs/dcf77_capture.h):
+    HEADER | DELTA_LO | [DELTA_HI] | [BIT_INDEX]
+    HEADER: [7] level, [6:4] decoder status, [3:2] bit index code, [0] DELTA_HI present
+
+Usage:
+    dcf77_recorder.py record /dev/ttyUSB0 -o field.dcfcap --duration 600
+    dcf77_recorder.py record /dev/ttyUSB0 -o field.dcfcap --fast 62500
+    dcf77_recorder.py decode field.dcfcap > field.csv
+
+Recording requires pyserial.
+"""
+
+#-------------------------------------------------------------------------------
+
+import argparse
+import sys
+import time
+
+#-------------------------------------------------------------------------------
+
+FILE_MAGIC = b'DCF77CAP'
+FILE_VERSION = 1
+
+SYNC = 0xA5
+MAX_PAYLOAD = 16
+CRC8_POLY = 0x07
+
+TYPE_GET_TIME = 0x01
+TYPE_SET_CAPTURE = 0x0D
+TYPE_SET_BAUDRATE = 0x0E
+TYPE_CAPTURE = 0x42
+TYPE_RESPONSE = 0x80
+TYPE_NACK = 0x7F
+
+STATUS_NAMES = ['WAITING', 'FRAME_STARTED', 'BIT_RECEIVED', 'BREAK_RECEIVED', 'ERROR', 'SYNCED', 'GLITCH', 'OVERFLOW']
+STATUS_OVERFLOW = 7
+
+INDEX_SAME, INDEX_NEXT, INDEX_ZERO, INDEX_EXPLICIT = range(4)
+
+BAUDRATE_CONFIRM_TIMEOUT = 2.0  # Device falls back to reset baud rate without valid frame in that time
+COMMAND_BYTE_GAP = 0.0002       # Device RX interrupt is close to byte time at 62500 baud
+
+#-------------------------------------------------------------------------------
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ CRC8_POLY) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def encode_frame(frame_type, payload=b''):
+    body = bytes([len(payload), frame_type]) + payload
+    return bytes([SYNC]) + body + bytes([crc8(body)])
+
+
+class FrameParser:
+    """Byte-wise parser mirroring serial_protocol_parse (resynchronizes on sync byte after error)."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.errors = 0
+
+    def feed(self, data):
+        self.buf += data
+        frames = []
+
+        while True:
+            start = self.buf.find(SYNC)
+            if start < 0:
+                self.buf.clear()
+                break
+            del self.buf[:start]
+
+            if len(self.buf) < 2:
+                break
+
+            length = self.buf[1]
+            if length > MAX_PAYLOAD:
+                self.errors += 1
+                del self.buf[:1]
+                continue
+
+            size = length + 4
+            if len(self.buf) < size:
+                break
+
+            body = bytes(self.buf[1:size - 1])
+            if crc8(body) != self.buf[size - 1]:
+                self.errors += 1
+                del self.buf[:1]
+                continue
+
+            frames.append((body[1], body[2:]))
+            del self.buf[:size]
+
+        return frames
+
+
+def decode_records(stream):
+    """Yields (delta_ms, level, status, bit_index) tuples, stops at incomplete record."""
+    pos = 0
+    prev_index = 0
+
+    while pos < len(stream):
+        header = stream[pos]
+        code = (header >> 2) & 0x03
+        delta_hi = header & 0x01
+        size = 2 + delta_hi + (code == INDEX_EXPLICIT)
+
+        if pos + size > len(stream):
+            break
+
+        delta = stream[pos + 1] | ((stream[pos + 2] << 8) if delta_hi else 0)
+        level = (header >> 7) & 0x01
+        status = (header >> 4) & 0x07
+
+        if code == INDEX_SAME:
+            index = prev_index
+        elif code == INDEX_NEXT:
+            index = (prev_index + 1) & 0xFF
+        elif code == INDEX_ZERO:
+            index = 0
+        else:
+            index = stream[pos + size - 1]
+
+        if status != STATUS_OVERFLOW:
+            prev_index = index
+
+        yield delta, level, status, index
+        pos += size
+
+def send_command(port, frame_type, payload=b''):
+    for byte in encode_frame(frame_type, payload):
+        port.write(bytes([byte]))
+        port.flush()
+        time.sleep(COMMAND_BYTE_GAP)
+
+
+def wait_response(port, parser, frame_type, timeout=1.0):
+    """Returns True on response to given command, False on NACK or timeout (other frames are dropped)."""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        for received_type, payload in parser.feed(port.read(64)):
+            if received_type == frame_type | TYPE_RESPONSE:
+                return True
+            if received_type == TYPE_NACK and payload[:1] == bytes([frame_type]):
+                return False
+    return False
+
+
+def set_baudrate(port, parser, baudrate):
+    """Switches device and port to given baud rate and confirms it before device falls back."""
+    send_command(port, TYPE_SET_BAUDRATE, baudrate.to_bytes(4, 'little'))
+    if not wait_response(port, parser, TYPE_SET_BAUDRATE):
+        return False
+
+    port.baudrate = baudrate
+    port.reset_input_buffer()
+    parser.buf.clear()
+
+    send_command(port, TYPE_GET_TIME)
+    return wait_response(port, parser, TYPE_GET_TIME, BAUDRATE_CONFIRM_TIMEOUT / 2)
+
+#-------------------------------------------------------------------------------
+
+def record(args):
+    try:
+        import serial
+    except ImportError:
+        print('error: recording requires pyserial (pip install pyserial)', file=sys.stderr)
+        return 1
+
+    parser = FrameParser()
+    captured = 0
+
+    with serial.Serial(args.port, args.baud, timeout=0.1) as port, open(args.output, 'wb') as out:
+        out.write(FILE_MAGIC + bytes([FILE_VERSION]))
+
+        if args.fast and not set_baudrate(port, parser, args.fast):
+            print('error: device did not switch to %d baud' % args.fast, file=sys.stderr)
+            return 1
+
+        send_command(port, TYPE_SET_CAPTURE, b'\x01')
+
+        start = time.monotonic()
+        try:
+            while not args.duration or time.monotonic() - start < args.duration:
+                for frame_type, payload in parser.feed(port.read(256)):
+                    if frame_type == TYPE_CAPTURE:
+                        out.write(payload)
+                        out.flush()
+                        captured += len(payload)
+                    elif frame_type == TYPE_NACK:
+                        print('error: capture command rejected', file=sys.stderr)
+                        return 1
+        except KeyboardInterrupt:
+            pass
+        finally:
+            send_command(port, TYPE_SET_CAPTURE, b'\x00')
+            if args.fast:
+                send_command(port, TYPE_SET_BAUDRATE, args.baud.to_bytes(4, 'little'))
+
+    print('captured %d B, frame errors %d' % (captured, parser.errors), file=sys.stderr)
+    return 0
+
+
+def decode(args):
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    if not data.startswith(FILE_MAGIC) or data[len(FILE_MAGIC)] != FILE_VERSION:
+        print('error: not a DCF77 capture file', file=sys.stderr)
+        return 1
+
+    stream = data[len(FILE_MAGIC) + 1:]
+    t = 0
+
+    print('t_ms,delta_ms,level,status,bit_index')
+
+    for delta, level, status, index in decode_records(stream):
+        if status == STATUS_OVERFLOW:
+            print('# %d records dropped by device' % delta)
+            continue
+        t += delta
+        print('%d,%d,%d,%s,%d' % (t, delta, level, STATUS_NAMES[status], index))
+
+    return 0
+
+#-------------------------------------------------------------------------------
+
+def main():
+    parser = argparse.ArgumentParser(description='DCF77 raw pulse recorder')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    rec = sub.add_parser('record', help='record pulses from device')
+    rec.add_argument('port', help='serial port')
+    rec.add_argument('-o', '--output', required=True, help='recording file')
+    rec.add_argument('--baud', type=int, default=9600, help='baud rate')
+    rec.add_argument('--fast', type=int, default=0, help='switch device to given baud rate for recording (31250 or 62500)')
+    rec.add_argument('--duration', type=float, default=0, help='recording time in s (0 - until Ctrl+C)')
+    rec.set_defaults(func=record)
+
+    dec = sub.add_parser('decode', help='print recording as CSV')
+    dec.add_argument('input', help='recording file')
+    dec.set_defaults(func=decode)
+
+    args = parser.parse_args()
+    return args.func(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
+
+#-------------------------------------------------------------------------------
@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+
+#-------------------------------------------------------------------------------
+
+# Copyright 2025 Michal Lokcewicz
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#-------------------------------------------------------------------------------
+
+"""Worst-case stack depth estimation for AVR firmware.
+
+Disassembles the ELF with avr-objdump, computes stack frame of every function
+(pushes, 'rcall .+0' and SP / Y-pointer adjustments in prologue) and walks the
+call graph (call / rcall, tail jumps) from main and from every interrupt vector.
+
+Worst case = deepest main path + deepest ISR path (ISRs are not nested).
+
+Indirect calls (icall / eicall - used by driver callbacks) cannot be resolved
+from the disassembly and have to be given with --icall, functions with dynamic
+stack allocation (VLA / alloca) have to be given with --dynamic, otherwise they
+are reported as unresolved and the result is a lower bound.
+
+Usage:
+    stack_depth.py dcf77_clock.elf
+    stack_depth.py --icall exti_mas6181B_cb,exti_sqw_cb --dynamic ds1307_save_to_ram=57 dcf77_clock.elf
+"""
+
+#-------------------------------------------------------------------------------
+
+import argparse
+import re
+import subprocess
+import sys
+
+#-------------------------------------------------------------------------------
+
+RETURN_ADDRESS_SIZE = 2     # 16-bit PC (devices up to 128 KB flash)
+
+FUNC_RE = re.compile(r'^([0-9a-f]+) <([^>]+)>:$')
+INSN_RE = re.compile(r'^\s*([0-9a-f]+):\s+(?:[0-9a-f]{2} )+\s*(\S+)\s*([^;]*)(?:;\s*(.*))?$')
+TARGET_RE = re.compile(r'<([^>+]+)(\+0x[0-9a-f]+)?>')
+
+#-------------------------------------------------------------------------------
+
+class Function:
+    def __init__(self, name):
+        self.name = name
+        self.frame = 0
+        self.calls = set()
+        self.tail_calls = set()
+        self.icall = False
+        self.sp_reads = 0
+
+#-------------------------------------------------------------------------------
+
+def disassemble(elf, objdump):
+    return subprocess.run([objdump, '-d', elf], check=True, capture_output=True, text=True).stdout
+
+
+def parse(text):
+    funcs = {}
+    func = None
+    frame_reg_loaded = False
+
+    for line in text.splitlines():
+        m = FUNC_RE.match(line)
+        if m:
+            func = funcs.setdefault(m.group(2), Function(m.group(2)))
+            frame_reg_loaded = False
+            continue
+
+        if func is None:
+            continue
+
+        m = INSN_RE.match(line)
+        if not m:
+            continue
+
+        op, args, comment = m.group(2), m.group(3).strip(), m.group(4) or ''
+        args = [a.strip() for a in args.split(',')] if args else []
+
+        if op == 'push':
+            func.frame += 1
+        elif op == 'rcall' and args and args[0] == '.+0':
+            func.frame += RETURN_ADDRESS_SIZE   # GCC allocates small frames with 'rcall .+0'
+        elif op == 'in' and len(args) == 2 and args[1] in ('0x3d', '0x3e'):
+            if args[1] == '0x3d':
+                func.sp_reads += 1
+            frame_reg_loaded = True
+        elif op == 'sbiw' and frame_reg_loaded and args[0] in ('r28', 'r29'):
+            func.frame += int(args[1], 0)
+            frame_reg_loaded = False
+        elif op == 'subi' and frame_reg_loaded and args[0] == 'r28':
+            func.frame += int(args[1], 0) & 0xFF
+        elif op == 'sbci' and frame_reg_loaded and args[0] == 'r29':
+            func.frame += (int(args[1], 0) & 0xFF) << 8
+            frame_reg_loaded = False
+        elif op in ('call', 'rcall', 'jmp', 'rjmp'):
+            t = TARGET_RE.search(comment)
+            if not t or t.group(2):     # Jump inside function or unknown target
+                continue
+            if t.group(1) == func.name:
+                continue
+            if op in ('call', 'rcall'):
+                func.calls.add(t.group(1))
+            else:
+                func.tail_calls.add(t.group(1))
+        elif op in ('icall', 'eicall'):
+            func.icall = True
+        elif op in ('ijmp', 'eijmp'):
+            func.icall = True
+
+    return funcs
+
+
+class Analyzer:
+    def __init__(self, funcs, icall_targets, dynamic):
+        self.funcs = funcs
+        self.icall_targets = icall_targets
+        self.dynamic = dynamic
+        self.cache = {}
+        self.warnings = set()
+
+    def depth(self, name, stack=()):
+        """Returns (depth in bytes, worst path) of given function excluding its return address."""
+        if name in self.cache:
+            return self.cache[name]
+
+        if name in stack:
+            self.warnings.add('recursion: ' + ' -> '.join(stack + (name,)))
+            return 0, [name]
+
+        func = self.funcs.get(name)
+        if func is None:
+            self.warnings.add('unknown function: ' + name)
+            return 0, [name]
+
+        frame = func.frame
+
+        if func.sp_reads > 1:
+            if name in self.dynamic:
+                frame += self.dynamic[name]
+            else:
+                self.warnings.add('dynamic stack allocation not bounded (use --dynamic): ' + name)
+
+        callees = [(c, RETURN_ADDRESS_SIZE) for c in func.calls]
+        callees += [(c, 0) for c in func.tail_calls]
+
+        if func.icall:
+            if self.icall_targets:
+                callees += [(c, RETURN_ADDRESS_SIZE) for c in self.icall_targets]
+            else:
+                self.warnings.add('indirect call not resolved (use --icall): ' + name)
+
+        worst, worst_path = 0, []
+
+        for callee, ret in callees:
+            d, path = self.depth(callee, stack + (name,))
+            if d + ret > worst:
+                worst, worst_path = d + ret, path
+
+        # Tail jump reuses caller frame after epilogue, still counted conservatively
+        result = (frame + worst, [name] + worst_path)
+        self.cache[name] = result
+        return result
+
+#-------------------------------------------------------------------------------
+
+def main():
+    parser = argparse.ArgumentParser(description='Worst-case call-graph stack depth of AVR ELF')
+    parser.add_argument('elf', help='ELF file (or disassembly text with --disasm)')
+    parser.add_argument('--objdump', default='avr-objdump', help='avr-objdump executable')
+    parser.add_argument('--disasm', action='store_true', help='input is avr-objdump -d output')
+    parser.add_argument('--icall', default='', help='comma separated list of possible indirect call targets')
+    parser.add_argument('--dynamic', action='append', default=[], help='FUNC=BYTES bound of dynamic allocation')
+    parser.add_argument('--ram', type=int, default=0, help='RAM available for stack (print margin)')
+    args = parser.parse_args()
+
+    if args.disasm:
+        with open(args.elf) as f:
+            text = f.read()
+    else:
+        text = disassemble(args.elf, args.objdump)
+
+    icall_targets = [t for t in args.icall.split(',') if t]
+    dynamic = {}
+    for item in args.dynamic:
+        name, size = item.split('=')
+        dynamic[name] = int(size, 0)
+
+    funcs = parse(text)
+    analyzer = Analyzer(funcs, icall_targets, dynamic)
+
+    main_depth, main_path = analyzer.depth('main')
+    main_depth += RETURN_ADDRESS_SIZE   # main is called from startup code
+
+    isr_depth, isr_path = 0, []
+    for name in sorted(funcs):
+        if re.fullmatch(r'__vector_\d+', name):
+            d, path = analyzer.depth(name)
+            d += RETURN_ADDRESS_SIZE    # Interrupted PC
+            print('%-24s %4d B  %s' % (name, d, ' -> '.join(path)))
+            if d > isr_depth:
+                isr_depth, isr_path = d, path
+
+    print('%-24s %4d B  %s' % ('main', main_depth, ' -> '.join(main_path)))
+    print('worst case (main + ISR)  %4d B' % (main_depth + isr_depth))
+
+    if args.ram:
+        print('stack margin             %4d B' % (args.ram - main_depth - isr_depth))
+
+    for warning in sorted(analyzer.warnings):
+        print('warning: ' + warning, file=sys.stderr)
+
+    return 1 if analyzer.warnings else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
+
+#-------------------------------------------------------------------------------
@@ -0,0 +1,483 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#include "analyzer.h"
+
+#include <cstring>
+
+#include <dcf77_capture.h>
+#include <dcf77_decoder.h>
+#include <serial_protocol.h>
+
+//------------------------------------------------------------------------------
+
+namespace telemetry
+{
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+constexpr char CAPTURE_FILE_MAGIC[] = "DCF77CAP";
+constexpr size_t CAPTURE_FILE_MAGIC_SIZE = sizeof(CAPTURE_FILE_MAGIC) - 1;
+constexpr uint8_t CAPTURE_FILE_VERSION = 1;
+
+/* Device side layouts (app/event.h, packed, short enums) */
+constexpr uint8_t TIME_INFO_SIZE = 7;   /* struct ds1307_time */
+constexpr uint8_t DIAG_SIZE = 8;        /* struct event_sync_time_status_data */
+constexpr uint8_t DIAG_SIZE_V2 = 7;     /* Without quality (firmware before signal quality metrics) */
+constexpr uint8_t DIAG_SIZE_V1 = 6;     /* Without confidence (firmware before frame confirmation) */
+
+enum diag_status
+{
+    DIAG_STATUS_WAITING,
+    DIAG_STATUS_FRAME_STARTED,
+    DIAG_STATUS_ERROR,
+    DIAG_STATUS_SYNCED,
+    DIAG_STATUS_UNCONFIRMED,
+};
+
+const char *const anomaly_names[ANOMALY_MAX] =
+{
+    "frame error",
+    "invalid time",
+    "time jump",
+    "time gap",
+    "glitch",
+    "capture overflow",
+    "decoder mismatch",
+    "decoded time jump",
+};
+
+//------------------------------------------------------------------------------
+
+void report(struct file_result &result, uint64_t offset, enum anomaly_type type, int32_t value)
+{
+    result.stats.anomalies[type]++;
+
+    if (result.sample_count < ANOMALY_SAMPLES)
+        result.samples[result.sample_count++] = {offset, type, value};
+}
+
+void add_pulse(struct stats &stats, uint16_t ms, bool bit)
+{
+    stats.pulses++;
+
+    if (bit)
+    {
+        unsigned bin = ms / BIT_HISTOGRAM_BIN_MS;
+        stats.bit_histogram[bin < BIT_HISTOGRAM_BINS ? bin : BIT_HISTOGRAM_BINS - 1]++;
+    }
+    else
+    {
+        unsigned bin = ms / BREAK_HISTOGRAM_BIN_MS;
+        stats.break_histogram[bin < BREAK_HISTOGRAM_BINS ? bin : BREAK_HISTOGRAM_BINS - 1]++;
+    }
+}
+
+/* Days since 2000-01-01 of given date (year 0-99 means 2000-2099) */
+int32_t days_since_2000(unsigned year, unsigned month, unsigned date)
+{
+    int32_t y = 2000 + year - (month <= 2);
+    int32_t era = y / 400;
+    int32_t yoe = y - era * 400;
+    int32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + date - 1;
+    int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 730425; /* 730425 - days from 0000-03-01 to 2000-01-01 */
+}
+
+bool time_info_to_seconds(const uint8_t *payload, int64_t &seconds)
+{
+    uint8_t sec = payload[0];
+    uint8_t min = payload[1];
+    uint8_t hour = payload[2];
+    uint8_t date = payload[4];
+    uint8_t month = payload[5];
+    uint8_t year = payload[6];
+
+    if (sec >= 60 || min >= 60 || hour >= 24 || date < 1 || date > 31 || month < 1 || month > 12 || year >= 100)
+        return false;
+
+    seconds = ((int64_t)days_since_2000(year, month, date) * 24 + hour) * 3600 + min * 60 + sec;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+struct serial_log_state
+{
+    bool time_valid;
+    int64_t prev_time;
+    uint64_t errors_at_prev_time;
+    bool sync_seen;             /* Diagnostics reported synchronization since previous time info */
+    bool correction_valid;
+    int64_t prev_correction_time;
+};
+
+void process_time_info(const struct analyzer_cfg &cfg, struct serial_log_state &state, const uint8_t *payload,
+                       uint64_t offset, struct file_result &result)
+{
+    struct stats &stats = result.stats;
+    int64_t time;
+
+    stats.time_infos++;
+
+    if (!time_info_to_seconds(payload, time))
+    {
+        report(result, offset, ANOMALY_TIME_INVALID, 0);
+        return;
+    }
+
+    if (state.time_valid)
+    {
+        int64_t step = time - state.prev_time;
+        int64_t correction = step - 1;
+        bool frames_lost = stats.anomalies[ANOMALY_FRAME_ERROR] != state.errors_at_prev_time;
+        bool in_range = correction >= -(int64_t)cfg.max_correction_s && correction <= (int64_t)cfg.max_correction_s;
+
+        if (frames_lost && !state.sync_seen && step > 1 && step <= cfg.max_correction_s)
+        {
+            report(result, offset, ANOMALY_TIME_GAP, (int32_t)(step - 1));
+        }
+        else if ((correction != 0 || state.sync_seen) && in_range)
+        {
+            stats.corrections++;
+
+            if (state.correction_valid)
+            {
+                stats.drift_correction_s += correction;
+                stats.drift_interval_s += (uint64_t)(state.prev_time - state.prev_correction_time);
+            }
+
+            state.correction_valid = true;
+            state.prev_correction_time = time;
+        }
+        else if (correction != 0)
+        {
+            report(result, offset, ANOMALY_TIME_JUMP, (int32_t)correction);
+
+            state.correction_valid = false; /* Interval since previous correction is not known anymore */
+        }
+    }
+
+    state.time_valid = true;
+    state.prev_time = time;
+    state.errors_at_prev_time = stats.anomalies[ANOMALY_FRAME_ERROR];
+    state.sync_seen = false;
+}
+
+void process_diag(struct serial_log_state &state, const uint8_t *payload, struct stats &stats)
+{
+    bool bit = payload[0];
+    uint8_t bit_number = payload[1];
+    uint16_t ms = (uint16_t)(payload[2] | (payload[3] << 8));
+    uint8_t status = payload[5];
+
+    add_pulse(stats, ms, bit);
+
+    /* Status is kept by device between pulses, frame start is the pulse which zeroed bit counter */
+    if (status == DIAG_STATUS_FRAME_STARTED && bit_number == 0)
+    {
+        stats.frames_started++;
+    }
+    else if (status == DIAG_STATUS_ERROR && bit_number == 0)
+    {
+        stats.decoder_errors++;
+    }
+    else if (status == DIAG_STATUS_SYNCED)
+    {
+        stats.frames_synced++;
+        state.sync_seen = true;
+    }
+}
+
+/* CRC-8 table built from firmware bitwise implementation - crc8(crc, byte) == table[crc ^ byte] */
+struct crc8_table
+{
+    uint8_t table[256];
+
+    crc8_table()
+    {
+        for (unsigned i = 0; i < 256; i++)
+            table[i] = serial_protocol_crc8(0, (uint8_t)i);
+    }
+};
+
+const struct crc8_table crc8;
+
+/* Equivalent of serial_protocol_parse() over whole buffer - frames are validated in place (no copy),
+   after error next sync byte is searched from byte following rejected sync byte */
+void analyze_serial_log(const struct analyzer_cfg &cfg, const uint8_t *data, size_t size, struct file_result &result)
+{
+    struct serial_log_state state = {};
+    struct stats &stats = result.stats;
+    size_t pos = 0;
+
+    while (pos + SERIAL_PROTOCOL_OVERHEAD <= size)
+    {
+        const uint8_t *sync = static_cast<const uint8_t *>(memchr(data + pos, SERIAL_PROTOCOL_SYNC, size - pos));
+
+        if (!sync)
+            break;
+
+        pos = (size_t)(sync - data);
+
+        if (pos + SERIAL_PROTOCOL_OVERHEAD > size)
+            break;
+
+        uint8_t len = data[pos + 1];
+
+        if (len > SERIAL_PROTOCOL_MAX_PAYLOAD)
+        {
+            report(result, pos, ANOMALY_FRAME_ERROR, 0);
+            pos++;
+            continue;
+        }
+
+        if (pos + len + SERIAL_PROTOCOL_OVERHEAD > size)
+            break; /* Log ends in the middle of frame */
+
+        uint8_t crc = 0;
+
+        for (size_t i = pos + 1; i < pos + len + 3; i++)
+            crc = crc8.table[crc ^ data[i]];
+
+        if (crc != data[pos + len + 3])
+        {
+            report(result, pos, ANOMALY_FRAME_ERROR, 0);
+            pos++;
+            continue;
+        }
+
+        uint8_t type = data[pos + 2];
+        const uint8_t *payload = data + pos + 3;
+
+        stats.frames++;
+
+        if (type == SERIAL_PROTOCOL_TYPE_TIME_INFO && len == TIME_INFO_SIZE)
+            process_time_info(cfg, state, payload, pos, result);
+        else if (type == SERIAL_PROTOCOL_TYPE_DIAG && (len == DIAG_SIZE || len == DIAG_SIZE_V2 || len == DIAG_SIZE_V1))
+            process_diag(state, payload, stats);
+
+        pos += len + SERIAL_PROTOCOL_OVERHEAD;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+int64_t frame_to_minutes(const uint8_t *frame)
+{
+    unsigned minutes = 10 * DCF77_DECODER_FRAME_GET_MINUTES_TENS(frame) + DCF77_DECODER_FRAME_GET_MINUTES_UNITS(frame);
+    unsigned hours = 10 * DCF77_DECODER_FRAME_GET_HOURS_TENS(frame) + DCF77_DECODER_FRAME_GET_HOURS_UNITS(frame);
+    unsigned date = 10 * DCF77_DECODER_FRAME_GET_DAY_TENS(frame) + DCF77_DECODER_FRAME_GET_DAY_UNITS(frame);
+    unsigned month = 10 * DCF77_DECODER_FRAME_GET_MONTH_TENS(frame) + DCF77_DECODER_FRAME_GET_MONTH_UNITS(frame);
+    unsigned year = 10 * DCF77_DECODER_FRAME_GET_YEAR_TENS(frame) + DCF77_DECODER_FRAME_GET_YEAR_UNITS(frame);
+
+    if (month < 1 || month > 12)
+        return -1;
+
+    return ((int64_t)days_since_2000(year, month, date) * 24 + hours) * 60 + minutes;
+}
+
+void analyze_capture(const uint8_t *data, size_t size, struct file_result &result)
+{
+    struct stats &stats = result.stats;
+    size_t pos = CAPTURE_FILE_MAGIC_SIZE + 1;
+    uint8_t prev_bit_index = 0;
+    bool aligned = false;           /* Host decoder follows device decoder (after common frame start) */
+    enum dcf77_decoder_status prev_status = DCF77_DECODER_STATUS_WAITING;   /* Status of the last final segment */
+    bool glitch = false;            /* Odd number of glitches since the last segment */
+    bool segment_level = false;
+
+    /* Outcome of the last segment - counted when it cannot be merged with following glitch anymore (e.g. break split
+       by spike gives period error first) */
+    struct
+    {
+        bool started;
+        bool lost;
+        enum dcf77_decoder_status status;
+    } pending = {false, false, DCF77_DECODER_STATUS_WAITING};
+    int64_t prev_minutes = -1;      /* Time of previous valid frame if no pulses were lost since then */
+
+    dcf77_decoder_reset();
+
+    while (pos < size)
+    {
+        struct dcf77_capture_record record;
+        size_t left = size - pos;
+        uint8_t used = dcf77_capture_decode(data + pos, left > UINT16_MAX ? UINT16_MAX : (uint16_t)left, &prev_bit_index, &record);
+
+        if (!used)
+            break; /* Recording interrupted in the middle of record */
+
+        if (record.status == DCF77_CAPTURE_STATUS_OVERFLOW)
+        {
+            report(result, pos, ANOMALY_CAPTURE_OVERFLOW, record.delta_ms);
+
+            dcf77_decoder_reset();
+            aligned = false;
+            glitch = false;
+            prev_minutes = -1;
+            pos += used;
+            continue;
+        }
+
+        add_pulse(stats, record.delta_ms, record.level);
+
+        if (record.level && record.delta_ms < GLITCH_MAX_MS)
+            report(result, pos, ANOMALY_GLITCH, record.delta_ms);
+
+        enum dcf77_decoder_status status = dcf77_decode(record.delta_ms, record.level);
+
+        if (!aligned && status == DCF77_DECODER_STATUS_FRAME_STARTED && record.status == DCF77_DECODER_STATUS_FRAME_STARTED)
+            aligned = true;
+        else if (aligned && status != record.status)
+        {
+            report(result, pos, ANOMALY_DECODER_MISMATCH, (int32_t)(status << 8 | record.status));
+            aligned = false;
+        }
+
+        if (status == DCF77_DECODER_STATUS_GLITCH)
+        {
+            glitch = !glitch;
+            pos += used;
+            continue;
+        }
+
+        /* Segment split by odd number of glitches was decoded again - its status replaces the previous one */
+        bool redecoded = glitch && record.level == segment_level;
+
+        glitch = false;
+        segment_level = record.level;
+
+        /* Previous segment is final unless this one replaced it */
+        if (!redecoded)
+        {
+            stats.frames_started += pending.started;
+
+            if (pending.lost)
+            {
+                stats.decoder_errors++;
+                prev_minutes = -1;
+            }
+
+            prev_status = pending.status;
+        }
+
+        /* Minute mark completing frame from bits received before it starts the next frame as well */
+        pending.started = status == DCF77_DECODER_STATUS_FRAME_STARTED || (status == DCF77_DECODER_STATUS_SYNCED && !record.level);
+
+        /* Minute mark inside frame - frame is lost, the next one starts with it */
+        pending.lost = status == DCF77_DECODER_STATUS_ERROR ||
+                       (status == DCF77_DECODER_STATUS_FRAME_STARTED && prev_status == DCF77_DECODER_STATUS_BIT_RECEIVED);
+        pending.status = status;
+
+        if (status == DCF77_DECODER_STATUS_SYNCED)
+        {
+            uint8_t frame[8];
+
+            memcpy(frame, (const void *)dcf77_get_frame(), sizeof(frame));
+
+            int64_t minutes = frame_to_minutes(frame);
+
+            stats.frames_synced++;
+
+            if (prev_minutes >= 0 && minutes != prev_minutes + 1)
+                report(result, pos, ANOMALY_DECODED_TIME_JUMP, (int32_t)(minutes - prev_minutes));
+
+            prev_minutes = minutes;
+        }
+
+        pos += used;
+    }
+
+    /* End of capture - the last segment cannot be merged anymore */
+    stats.frames_started += pending.started;
+    stats.decoder_errors += pending.lost;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+void analyze(const struct analyzer_cfg &cfg, const uint8_t *data, size_t size, struct file_result &result)
+{
+    result.stats.files = 1;
+    result.stats.bytes = size;
+    result.ok = true;
+
+    if (size > CAPTURE_FILE_MAGIC_SIZE && !memcmp(data, CAPTURE_FILE_MAGIC, CAPTURE_FILE_MAGIC_SIZE))
+    {
+        result.kind = FILE_KIND_CAPTURE;
+
+        if (data[CAPTURE_FILE_MAGIC_SIZE] != CAPTURE_FILE_VERSION)
+        {
+            result.ok = false;
+            result.error = "unsupported capture file version";
+            return;
+        }
+
+        analyze_capture(data, size, result);
+    }
+    else
+    {
+        result.kind = FILE_KIND_SERIAL_LOG;
+
+        analyze_serial_log(cfg, data, size, result);
+    }
+}
+
+void merge(struct stats &total, const struct stats &part)
+{
+    total.files += part.files;
+    total.bytes += part.bytes;
+    total.frames += part.frames;
+    total.time_infos += part.time_infos;
+    total.corrections += part.corrections;
+    total.drift_correction_s += part.drift_correction_s;
+    total.drift_interval_s += part.drift_interval_s;
+    total.pulses += part.pulses;
+    total.frames_started += part.frames_started;
+    total.frames_synced += part.frames_synced;
+    total.decoder_errors += part.decoder_errors;
+
+    for (unsigned i = 0; i < BIT_HISTOGRAM_BINS; i++)
+        total.bit_histogram[i] += part.bit_histogram[i];
+
+    for (unsigned i = 0; i < BREAK_HISTOGRAM_BINS; i++)
+        total.break_histogram[i] += part.break_histogram[i];
+
+    for (unsigned i = 0; i < ANOMALY_MAX; i++)
+        total.anomalies[i] += part.anomalies[i];
+}
+
+const char *anomaly_name(enum anomaly_type type)
+{
+    return type < ANOMALY_MAX ? anomaly_names[type] : "unknown";
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace telemetry
+
+//------------------------------------------------------------------------------
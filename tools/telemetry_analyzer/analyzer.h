@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+#ifndef ANALYZER_H_
+#define ANALYZER_H_
+
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+namespace telemetry
+{
+
+//------------------------------------------------------------------------------
+
+/* Pulse width histograms - last bin collects everything above range */
+constexpr unsigned BIT_HISTOGRAM_BIN_MS = 10;
+constexpr unsigned BIT_HISTOGRAM_BINS = 32;
+constexpr unsigned BREAK_HISTOGRAM_BIN_MS = 100;
+constexpr unsigned BREAK_HISTOGRAM_BINS = 24;
+
+/* Number of anomalies stored with file offset for reporting (all of them are counted) */
+constexpr unsigned ANOMALY_SAMPLES = 8;
+
+/* Bit pulse shorter than shortest valid bit (dcf77_decoder.c) */
+constexpr unsigned GLITCH_MAX_MS = 40;
+
+//------------------------------------------------------------------------------
+
+enum file_kind
+{
+    FILE_KIND_SERIAL_LOG,   /* Raw serial stream dump (TIME_INFO / DIAG / other frames) */
+    FILE_KIND_CAPTURE,      /* tools/dcf77_recorder.py recording */
+};
+
+enum anomaly_type
+{
+    ANOMALY_FRAME_ERROR,        /* CRC or length error in serial stream */
+    ANOMALY_TIME_INVALID,       /* Time info out of range */
+    ANOMALY_TIME_JUMP,          /* Time step not explained by synchronization (time set, timezone change, reset) */
+    ANOMALY_TIME_GAP,           /* Time info lost together with corrupted frames */
+    ANOMALY_GLITCH,             /* Bit pulse shorter than GLITCH_MAX_MS */
+    ANOMALY_CAPTURE_OVERFLOW,   /* Records dropped by device, value is number of dropped records */
+    ANOMALY_DECODER_MISMATCH,   /* Host decoder status differs from status recorded by device */
+    ANOMALY_DECODED_TIME_JUMP,  /* Consecutive valid frames not one minute apart */
+    ANOMALY_MAX,
+};
+
+//------------------------------------------------------------------------------
+
+struct analyzer_cfg
+{
+    uint32_t max_correction_s;  /* Larger time steps are reported as jumps, not drift corrections */
+};
+
+struct stats
+{
+    uint64_t files;
+    uint64_t bytes;
+
+    /* Serial stream */
+    uint64_t frames;
+    uint64_t time_infos;
+    uint64_t corrections;           /* Time steps at synchronization (any size within max_correction_s) */
+    int64_t drift_correction_s;     /* Sum of corrections with known interval since previous correction */
+    uint64_t drift_interval_s;      /* Sum of those intervals */
+
+    /* Pulses (capture records or diagnostics frames) */
+    uint64_t pulses;
+    uint64_t frames_started;
+    uint64_t frames_synced;
+    uint64_t decoder_errors;
+    uint64_t bit_histogram[BIT_HISTOGRAM_BINS];
+    uint64_t break_histogram[BREAK_HISTOGRAM_BINS];
+
+    uint64_t anomalies[ANOMALY_MAX];
+};
+
+struct anomaly_sample
+{
+    uint64_t offset;    /* Byte offset in file */
+    enum anomaly_type type;
+    int32_t value;
+};
+
+struct file_result
+{
+    std::string path;
+    std::string device;
+    enum file_kind kind;
+    bool ok;
+    std::string error;
+    struct stats stats;
+    struct anomaly_sample samples[ANOMALY_SAMPLES];
+    uint8_t sample_count;
+};
+
+//------------------------------------------------------------------------------
+
+/// @brief Analyzes single memory-mapped file, kind is detected from capture file magic
+/// @note Uses thread-local DCF77 decoder, so files can be analyzed in parallel, no allocation per record
+/// @param cfg analyzer configuration
+/// @param data file contents
+/// @param size file size
+/// @param result output, stats have to be zeroed by caller
+void analyze(const struct analyzer_cfg &cfg, const uint8_t *data, size_t size, struct file_result &result);
+
+/// @brief Adds file or device statistics to given totals
+/// @param total accumulated statistics
+/// @param part statistics to add
+void merge(struct stats &total, const struct stats &part);
+
+/// @brief Returns anomaly name
+/// @param type anomaly type
+/// @return constant string
+const char *anomaly_name(enum anomaly_type type);
+
+//------------------------------------------------------------------------------
+
+} // namespace telemetry
+
+#endif /* ANALYZER_H_ */
+
+//------------------------------------------------------------------------------
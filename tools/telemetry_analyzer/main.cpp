@@ -0,0 +1,437 @@
+//------------------------------------------------------------------------------
+
+/*
+ * Copyright 2025 Michal Lokcewicz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//------------------------------------------------------------------------------
+
+/* Telemetry analyzer - decodes serial logs and DCF77 capture recordings of many devices in parallel
+   and reports per-device drift, synchronization success rate, pulse width histograms and anomalies.
+
+   Usage: telemetry_analyzer [options] <file | directory>...
+   Directories are walked recursively, capture files are detected by magic, other files are serial logs. */
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "analyzer.h"
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+
+enum device_from
+{
+    DEVICE_FROM_STEM,   /* File name up to first '_' or '.' (e.g. clock07_2025-03.log) */
+    DEVICE_FROM_DIR,    /* Parent directory name (e.g. clock07/2025-03.log) */
+};
+
+struct options
+{
+    unsigned jobs;
+    enum device_from device_from;
+    bool histograms;
+    bool anomalies;
+    bool csv;
+    struct telemetry::analyzer_cfg cfg;
+    std::vector<std::string> inputs;
+};
+
+//------------------------------------------------------------------------------
+
+/* Read-only private mapping, unmapped on scope exit */
+class mapped_file
+{
+public:
+    explicit mapped_file(const std::string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+            return;
+
+        struct stat st;
+
+        if (fstat(fd, &st) == 0)
+        {
+            size_ = (size_t)st.st_size;
+            valid_ = true;
+
+            if (size_)
+            {
+                void *addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                if (addr == MAP_FAILED)
+                {
+                    valid_ = false;
+                    size_ = 0;
+                }
+                else
+                {
+                    data_ = static_cast<const uint8_t *>(addr);
+                    madvise(addr, size_, MADV_SEQUENTIAL);
+                }
+            }
+        }
+
+        close(fd);
+    }
+
+    ~mapped_file()
+    {
+        if (data_)
+            munmap(const_cast<uint8_t *>(data_), size_);
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    bool valid() const { return valid_; }
+    const uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    bool valid_ = false;
+};
+
+//------------------------------------------------------------------------------
+
+void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options] <file | directory>...\n"
+            "  -j N                  worker threads (default: hardware concurrency)\n"
+            "  --device-from stem|dir device id from file name prefix (default) or parent directory\n"
+            "  --max-correction S    largest time step treated as synchronization (default: 300 s)\n"
+            "  --histograms          print pulse width histograms per device\n"
+            "  --anomalies           print first anomalies of every file with byte offset\n"
+            "  --csv                 print per-device summary as CSV\n",
+            name);
+}
+
+bool parse_options(int argc, char **argv, struct options &opts)
+{
+    opts.jobs = std::max(1u, std::thread::hardware_concurrency());
+    opts.device_from = DEVICE_FROM_STEM;
+    opts.histograms = false;
+    opts.anomalies = false;
+    opts.csv = false;
+    opts.cfg.max_correction_s = 300;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (!strcmp(arg, "-j") && has_value)
+            opts.jobs = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(arg, "--device-from") && has_value)
+        {
+            const char *value = argv[++i];
+
+            if (!strcmp(value, "stem"))
+                opts.device_from = DEVICE_FROM_STEM;
+            else if (!strcmp(value, "dir"))
+                opts.device_from = DEVICE_FROM_DIR;
+            else
+                return false;
+        }
+        else if (!strcmp(arg, "--max-correction") && has_value)
+            opts.cfg.max_correction_s = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        else if (!strcmp(arg, "--histograms"))
+            opts.histograms = true;
+        else if (!strcmp(arg, "--anomalies"))
+            opts.anomalies = true;
+        else if (!strcmp(arg, "--csv"))
+            opts.csv = true;
+        else if (arg[0] == '-')
+            return false;
+        else
+            opts.inputs.push_back(arg);
+    }
+
+    return !opts.inputs.empty();
+}
+
+std::string device_id(const std::filesystem::path &path, enum device_from from)
+{
+    if (from == DEVICE_FROM_DIR)
+    {
+        std::string dir = path.parent_path().filename().string();
+
+        return dir.empty() ? "." : dir;
+    }
+
+    std::string name = path.filename().string();
+
+    return name.substr(0, std::min(name.find('_'), name.find('.')));
+}
+
+bool collect_files(const struct options &opts, std::vector<struct telemetry::file_result> &files)
+{
+    namespace fs = std::filesystem;
+
+    std::vector<fs::path> paths;
+
+    for (const std::string &input : opts.inputs)
+    {
+        std::error_code ec;
+
+        if (fs::is_directory(input, ec))
+        {
+            for (const fs::directory_entry &entry : fs::recursive_directory_iterator(input, ec))
+                if (entry.is_regular_file(ec))
+                    paths.push_back(entry.path());
+        }
+        else if (fs::is_regular_file(input, ec))
+            paths.push_back(input);
+        else
+        {
+            fprintf(stderr, "error: %s: no such file or directory\n", input.c_str());
+            return false;
+        }
+    }
+
+    std::sort(paths.begin(), paths.end());
+
+    files.resize(paths.size());
+
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        files[i] = {};
+        files[i].path = paths[i].string();
+        files[i].device = device_id(paths[i], opts.device_from);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+/* Workers take next file from shared index - large and small files balance without any queue */
+void analyze_files(const struct options &opts, std::vector<struct telemetry::file_result> &files)
+{
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    unsigned jobs = (unsigned)std::min<size_t>(opts.jobs, std::max<size_t>(files.size(), 1));
+
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < files.size(); i = next++)
+        {
+            struct telemetry::file_result &result = files[i];
+            mapped_file file(result.path);
+
+            if (!file.valid())
+            {
+                result.ok = false;
+                result.error = strerror(errno);
+                continue;
+            }
+
+            telemetry::analyze(opts.cfg, file.data(), file.size(), result);
+        }
+    };
+
+    for (unsigned i = 1; i < jobs; i++)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (std::thread &thread : workers)
+        thread.join();
+}
+
+//------------------------------------------------------------------------------
+
+double drift_ppm(const struct telemetry::stats &stats)
+{
+    /* Negative correction means device was ahead - positive drift */
+    return stats.drift_interval_s ? -1e6 * (double)stats.drift_correction_s / (double)stats.drift_interval_s : 0.0;
+}
+
+double sync_rate(const struct telemetry::stats &stats)
+{
+    return stats.frames_started ? 100.0 * (double)stats.frames_synced / (double)stats.frames_started : 0.0;
+}
+
+uint64_t anomaly_count(const struct telemetry::stats &stats)
+{
+    uint64_t count = 0;
+
+    for (unsigned i = 0; i < telemetry::ANOMALY_MAX; i++)
+        count += stats.anomalies[i];
+
+    return count;
+}
+
+void print_histogram(const char *title, const uint64_t *bins, unsigned count, unsigned bin_ms)
+{
+    uint64_t max = *std::max_element(bins, bins + count);
+
+    printf("  %s\n", title);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        if (!bins[i])
+            continue;
+
+        int bar = max ? (int)(50 * bins[i] / max) : 0;
+
+        if (i == count - 1)
+            printf("    >=%5u ms %12" PRIu64 " %.*s\n", i * bin_ms, bins[i], bar, "##################################################");
+        else
+            printf("    %5u-%-4u %12" PRIu64 " %.*s\n", i * bin_ms, (i + 1) * bin_ms, bins[i], bar, "##################################################");
+    }
+}
+
+void print_report(const struct options &opts, const std::vector<struct telemetry::file_result> &files)
+{
+    std::map<std::string, struct telemetry::stats> devices;
+    struct telemetry::stats total = {};
+
+    for (const struct telemetry::file_result &file : files)
+    {
+        if (!file.ok)
+        {
+            fprintf(stderr, "warning: %s: %s\n", file.path.c_str(), file.error.c_str());
+            continue;
+        }
+
+        telemetry::merge(devices[file.device], file.stats);
+        telemetry::merge(total, file.stats);
+    }
+
+    if (opts.csv)
+    {
+        printf("device,files,bytes,time_infos,corrections,drift_ppm,frames_started,frames_synced,sync_rate,decoder_errors,pulses");
+
+        for (unsigned i = 0; i < telemetry::ANOMALY_MAX; i++)
+            printf(",%s", telemetry::anomaly_name((enum telemetry::anomaly_type)i));
+
+        printf("\n");
+
+        for (const auto &[device, stats] : devices)
+        {
+            printf("%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.3f,%" PRIu64 ",%" PRIu64 ",%.1f,%" PRIu64 ",%" PRIu64,
+                   device.c_str(), stats.files, stats.bytes, stats.time_infos, stats.corrections, drift_ppm(stats),
+                   stats.frames_started, stats.frames_synced, sync_rate(stats), stats.decoder_errors, stats.pulses);
+
+            for (unsigned i = 0; i < telemetry::ANOMALY_MAX; i++)
+                printf(",%" PRIu64, stats.anomalies[i]);
+
+            printf("\n");
+        }
+
+        return;
+    }
+
+    printf("%-16s %6s %10s %10s %6s %10s %8s %8s %7s %10s %9s\n",
+           "device", "files", "MB", "time info", "corr", "drift ppm", "started", "synced", "sync %", "pulses", "anomalies");
+
+    for (const auto &[device, stats] : devices)
+    {
+        printf("%-16s %6" PRIu64 " %10.1f %10" PRIu64 " %6" PRIu64 " %10.2f %8" PRIu64 " %8" PRIu64 " %7.1f %10" PRIu64 " %9" PRIu64 "\n",
+               device.c_str(), stats.files, (double)stats.bytes / 1e6, stats.time_infos, stats.corrections, drift_ppm(stats),
+               stats.frames_started, stats.frames_synced, sync_rate(stats), stats.pulses, anomaly_count(stats));
+    }
+
+    printf("%-16s %6" PRIu64 " %10.1f %10" PRIu64 " %6" PRIu64 " %10s %8" PRIu64 " %8" PRIu64 " %7.1f %10" PRIu64 " %9" PRIu64 "\n",
+           "total", total.files, (double)total.bytes / 1e6, total.time_infos, total.corrections, "-",
+           total.frames_started, total.frames_synced, sync_rate(total), total.pulses, anomaly_count(total));
+
+    for (const auto &[device, stats] : devices)
+    {
+        if (!anomaly_count(stats) && !opts.histograms)
+            continue;
+
+        printf("\n%s\n", device.c_str());
+
+        for (unsigned i = 0; i < telemetry::ANOMALY_MAX; i++)
+            if (stats.anomalies[i])
+                printf("  %-20s %12" PRIu64 "\n", telemetry::anomaly_name((enum telemetry::anomaly_type)i), stats.anomalies[i]);
+
+        if (opts.histograms && stats.pulses)
+        {
+            print_histogram("bit pulse width [ms]", stats.bit_histogram, telemetry::BIT_HISTOGRAM_BINS, telemetry::BIT_HISTOGRAM_BIN_MS);
+            print_histogram("break width [ms]", stats.break_histogram, telemetry::BREAK_HISTOGRAM_BINS, telemetry::BREAK_HISTOGRAM_BIN_MS);
+        }
+    }
+
+    if (!opts.anomalies)
+        return;
+
+    for (const struct telemetry::file_result &file : files)
+    {
+        if (!file.sample_count)
+            continue;
+
+        printf("\n%s\n", file.path.c_str());
+
+        for (uint8_t i = 0; i < file.sample_count; i++)
+            printf("  @%-12" PRIu64 " %-20s %d\n", file.samples[i].offset, telemetry::anomaly_name(file.samples[i].type), file.samples[i].value);
+
+        if (anomaly_count(file.stats) > file.sample_count)
+            printf("  ... %" PRIu64 " more\n", anomaly_count(file.stats) - file.sample_count);
+    }
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    struct options opts;
+    std::vector<struct telemetry::file_result> files;
+
+    if (!parse_options(argc, argv, opts))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (!collect_files(opts, files))
+        return 1;
+
+    analyze_files(opts, files);
+
+    print_report(opts, files);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------